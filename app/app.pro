@@ -0,0 +1,42 @@
+################################################################################
+# Name:      app.pro
+# Purpose:   Qt project file of the fractal browser
+# Author:    Anton van Wezenbeek
+# Copyright: (c) 2017-2026 Anton van Wezenbeek
+################################################################################
+
+TEMPLATE = app
+TARGET = fractal
+QT += widgets
+RC_FILE = fractal.rc
+
+include ( ../core/core.pri )
+
+win32 {
+  include ( c:\qwt\features\qwt.prf )
+}
+
+linux-g++ {
+  include ( /usr/local/qwt/features/qwt.prf )
+}
+
+macx {
+  include ( /usr/local/Cellar/homebrew/Cellar/qwt/6.3.0/features/qwt.prf )
+}
+
+HEADERS += \
+  fractalcontrol.h \
+  fractalwidget.h \
+  mainwindow.h \
+  plotitem.h \
+  plotzoomer.h \
+  scrollbar.h
+
+SOURCES += \
+  fractalcontrol.cpp \
+  fractalwidget.cpp \
+  main.cpp \
+  mainwindow.cpp \
+  plotitem.cpp \
+  plotzoomer.cpp \
+  scrollbar.cpp
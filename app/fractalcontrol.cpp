@@ -54,6 +54,10 @@ void FractalControl::addControls(QToolBar* toolbar)
   m_depthEdit->setValue(m_geo.m_depth);
   m_depthEdit->setToolTip("depth");
   
+  m_guessEdit = new QCheckBox("Guess");
+  m_guessEdit->setToolTip("guess solid areas");
+  m_guessEdit->setChecked(m_geo.m_guess);
+  
   m_imagesSizeEdit = new QLineEdit();
   m_imagesSizeEdit->setToolTip("images max size");
   m_imagesSizeEdit->setValidator(new QRegularExpressionValidator(QRegularExpression(size_regexp)));
@@ -65,8 +69,13 @@ void FractalControl::addControls(QToolBar* toolbar)
   m_intervalsEdit->setToolTip("interval x,y");
   m_intervalsEdit->setValidator(new QRegularExpressionValidator(QRegularExpression(intervals_regexp)));
   m_intervalsEdit->setText(
-    QString::number(m_geo.m_intervalX.minValue()) + "," + QString::number(m_geo.m_intervalX.maxValue()) + "," +
-    QString::number(m_geo.m_intervalY.minValue()) + "," + QString::number(m_geo.m_intervalY.maxValue()));
+    QString::number(m_geo.intervalX().minValue()) + "," + QString::number(m_geo.intervalX().maxValue()) + "," +
+    QString::number(m_geo.intervalY().minValue()) + "," + QString::number(m_geo.intervalY().maxValue()));
+  
+  m_passesEdit = new QSpinBox();
+  m_passesEdit->setRange(1, 8);
+  m_passesEdit->setValue(m_geo.m_passes);
+  m_passesEdit->setToolTip("passes");
   
   m_useImagesEdit = new QCheckBox("Images");
   m_useImagesEdit->setToolTip("use images");
@@ -81,14 +90,20 @@ void FractalControl::addControls(QToolBar* toolbar)
     this, SLOT(setColoursMaxWave(int)));
   connect(m_depthEdit, SIGNAL(valueChanged(int)),
     this, SLOT(setDepth(int)));
+  connect(m_guessEdit, SIGNAL(stateChanged(int)),
+    this, SLOT(setGuess(int)));
   connect(m_imagesSizeEdit, SIGNAL(returnPressed()),
     this, SLOT(setImagesSize()));
   connect(m_intervalsEdit, SIGNAL(returnPressed()),
     this, SLOT(setIntervals()));
+  connect(m_passesEdit, SIGNAL(valueChanged(int)),
+    this, SLOT(setPasses(int)));
   connect(m_useImagesEdit, SIGNAL(stateChanged(int)),
     this, SLOT(setUseImages(int)));
     
   toolbar->addWidget(m_depthEdit);
+  toolbar->addWidget(m_passesEdit);
+  toolbar->addWidget(m_guessEdit);
   toolbar->addWidget(m_intervalsEdit);
   toolbar->addSeparator();
   toolbar->addWidget(m_coloursEdit);
@@ -178,6 +193,12 @@ void FractalControl::setDepth(int value)
   }
 }
 
+void FractalControl::setGuess(int state)
+{
+  m_geo.m_guess = (state == Qt::Checked);
+  emit changed();
+}
+
 void FractalControl::setImages()
 {
   setImages(true);
@@ -185,30 +206,14 @@ void FractalControl::setImages()
 
 void FractalControl::setImages(bool show_dialog)
 {
-  if (show_dialog)
-  {
-    m_geo.m_imagesList = QFileDialog::getOpenFileNames(
+  if (m_geo.setImages(show_dialog ?
+    QFileDialog::getOpenFileNames(
       nullptr,
       "Select Images",
       m_geo.m_dir.path(),
-      "Images (*.bmp *.gif  *.ico *.jpg *.png *.xpm)");
-  }
-
-  if (!m_geo.m_imagesList.isEmpty())
+      "Images (*.bmp *.gif  *.ico *.jpg *.png *.xpm)"):
+    m_geo.m_imagesList))
   {
-    m_geo.m_images.clear();
-    m_geo.m_dir = m_geo.m_imagesList[0];
-    
-    for (const auto & i : m_geo.m_imagesList)
-    {
-      const QImage image(i);
-      
-      m_geo.m_images.push_back(
-        (image.width() > m_geo.m_imagesSize.width() || 
-         image.height() > m_geo.m_imagesSize.height()) ?
-        image.scaled(m_geo.m_imagesSize): image);
-    }
-    
     emit changed();
   }
 }
@@ -230,7 +235,7 @@ void FractalControl::setIntervals()
   
   if (sl.size() == 4)
   {
-    setIntervals(
+    m_geo.setView(
       QwtInterval(sl[0].toDouble(), sl[1].toDouble()),    
       QwtInterval(sl[2].toDouble(), sl[3].toDouble()));
       
@@ -238,10 +243,30 @@ void FractalControl::setIntervals()
   }
 }
 
-void FractalControl::setIntervals(const QwtInterval& x, const QwtInterval& y)
+void FractalControl::setPasses(int value)
+{
+  if (value > 0)
+  {
+    m_geo.m_passes = value;
+    emit changed();
+  }
+}
+
+void FractalControl::setView(const FractalFrame& frame)
 {
-  m_geo.m_intervalX = x;
-  m_geo.m_intervalY = y;
+  m_geo.setView(
+    frame.centerX(), frame.centerY(), frame.width(), frame.height());
+  m_geo.setDepth(frame.depth());
+  m_geo.setGuess(frame.guess());
+  
+  // The edits are only there after addControls.
+  if (m_depthEdit != nullptr)
+  {
+    const QSignalBlocker depth(m_depthEdit);
+    const QSignalBlocker guess(m_guessEdit);
+    m_depthEdit->setValue(m_geo.m_depth);
+    m_guessEdit->setChecked(m_geo.m_guess);
+  }
 }
 
 void FractalControl::setUseImages(int state)
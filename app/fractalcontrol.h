@@ -2,7 +2,7 @@
 // Name:      fractalcontrol.h
 // Purpose:   Declaration of class FractalControl
 // Author:    Anton van Wezenbeek
-// Copyright: (c) 2017 Anton van Wezenbeek
+// Copyright: (c) 2017-2026 Anton van Wezenbeek
 ////////////////////////////////////////////////////////////////////////////////
 
 #pragma once
@@ -13,6 +13,7 @@
 #include <QSpinBox>
 #include <QToolBar>
 #include <qwt_interval.h>
+#include "fractalframe.h"
 #include "fractalgeometry.h"
 
 const QString pointf_regexp("-?[0-9.]+[0-9]*,-?[0-9.]+[0-9]*");
@@ -54,9 +55,10 @@ public:
   
   /// Sets all old colours into new colour.
   void setColours(uint old, uint colour);
-  
-  /// Sets intervals.
-  void setIntervals(const QwtInterval& x, const QwtInterval& y);
+
+  /// Sets view, depth and guess of a frame, the edits are updated
+  /// without emitting changed.
+  void setView(const FractalFrame& frame);
 signals:
   /// Whenever a control is changed, this signal is emitted.
   void changed();
@@ -78,8 +80,10 @@ private slots:
   void setColoursMax(int value);
   void setColoursMaxWave(int value);
   void setDepth(int value);
+  void setGuess(int state);
   void setImagesSize();
   void setIntervals();
+  void setPasses(int value);
   void setUseImages(int state);
 private:  
   void setColours(int colours);
@@ -88,9 +92,9 @@ private:
 
   FractalGeometry m_geo;
 
-  QCheckBox* m_useImagesEdit;
+  QCheckBox *m_guessEdit, *m_useImagesEdit;
   QColorDialog* m_colourDialog;
   QLineEdit *m_imagesSizeEdit, *m_intervalsEdit;
   QSpinBox *m_coloursEdit, *m_coloursMaxWaveEdit,
-    *m_coloursMinWaveEdit, *m_depthEdit;
+    *m_coloursMinWaveEdit, *m_depthEdit = nullptr, *m_passesEdit;
 };
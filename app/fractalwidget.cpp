@@ -7,6 +7,7 @@
 
 #include <math.h>
 #include <QApplication>
+#include <QFileDialog>
 #include <QtGui>
 #include <QRegularExpressionValidator>
 #include <qwt_plot_grid.h>
@@ -58,9 +59,9 @@ FractalWidget::FractalWidget(
 {
   init(fw.m_axesEdit->isChecked());
   
-  if (!fw.m_fractalPixmap.isNull())
+  if (!fw.m_fractalImage.isNull())
   { 
-    m_fractalPixmap = fw.m_fractalPixmap;
+    m_fractalImage = fw.m_fractalImage;
     update();
   }
 }
@@ -103,7 +104,7 @@ void FractalWidget::autoZoomStop()
 
 void FractalWidget::copy()
 {
-  QApplication::clipboard()->setImage(m_fractalPixmap.toImage());
+  QApplication::clipboard()->setImage(m_fractalImage);
   m_statusBar->showMessage("copied to clipboard", 50);
 }
 
@@ -111,8 +112,7 @@ bool FractalWidget::doubleClicked()
 {
   if (!m_fractalControl.geo().useImages())
   {
-    QImage image(m_fractalPixmap.toImage());
-    QRgb rgb = image.pixel(m_zoom->trackerPosition());
+    QRgb rgb = m_fractalImage.pixel(m_zoom->trackerPosition());
     
     const QColor color = QColorDialog::getColor(QColor(rgb));
     
@@ -186,8 +186,8 @@ void FractalWidget::init(bool show_axes)
   connect(&m_fractalControl, SIGNAL(changed()),
     this, SLOT(render()));
     
-  connect(&m_fractalRenderer, SIGNAL(rendered(QImage,int)),
-    this, SLOT(updatePixmap(QImage,int)));
+  connect(&m_fractalRenderer, SIGNAL(rendered(int,int)),
+    this, SLOT(updateImage(int,int)));
   connect(&m_fractalRenderer, SIGNAL(rendering(int,int)),
     this, SLOT(updateProgress(int,int)));
     
@@ -219,12 +219,14 @@ void FractalWidget::init(bool show_axes)
   auto* fractalitem = new FractalPlotItem();
   fractalitem->attach(this);
   
-  m_zoom = new PlotZoomer(canvas(), m_statusBar);
+  m_zoom = new PlotZoomer(canvas(), m_statusBar, m_fractalControl.geo());
   
   connect(&m_fractalControl, SIGNAL(changedIntervals()),
     this, SLOT(setIntervals()));
   connect(m_zoom, SIGNAL(zoomed(const QRectF&)),
     this, SLOT(zoomed()));
+  connect(m_zoom, SIGNAL(zoomedPart(const QRectF&)),
+    this, SLOT(zoomedPart(const QRectF&)));
 
   // After grid has been constructed.
   setAxes(show_axes ? Qt::Checked: Qt::Unchecked);
@@ -234,11 +236,8 @@ void FractalWidget::init(bool show_axes)
 
 void FractalWidget::render()
 {
-  m_fractalControl.setIntervals(
-    axisInterval(xBottom), axisInterval(yLeft));
-
-  if (m_fractalRenderer.render(*this, 
-    QImage(size(), QImage::Format_RGB32), m_fractalControl.geo()))
+  // The view is kept by the geometry, the axes approximate it.
+  if (m_fractalRenderer.render(*this, size(), m_fractalControl.geo()))
   {
     m_progressBar->setMinimum(0);
     m_progressBar->setMaximum(size().height());
@@ -246,6 +245,37 @@ void FractalWidget::render()
   }
 }
 
+void FractalWidget::openFrame()
+{
+  const QString file(QFileDialog::getOpenFileName(this, "Open Frame",
+    QString(), "Frames (*.frame)"));
+  
+  if (file.isEmpty())
+  {
+    return;
+  }
+  
+  FractalFrame frame;
+  
+  if (!frame.open(file))
+  {
+    m_statusBar->showMessage("could not open " + file);
+    return;
+  }
+  
+  // The frame is only coloured when the size is the size of the frame.
+  m_fractalRenderer.setFrame(frame);
+  resume(frame);
+  
+  if (frame.size() != size())
+  {
+    m_sizeEdit->setText(
+      QString::number(frame.size().width()) + "," + 
+      QString::number(frame.size().height()));
+    setSize();
+  }
+}
+
 void FractalWidget::resizeEvent(QResizeEvent* event)
 {
   QwtPlot::resizeEvent(event);
@@ -257,6 +287,30 @@ void FractalWidget::resizeEvent(QResizeEvent* event)
     QString::number(size().width()) + "," + QString::number(size().height()));
 }
 
+void FractalWidget::resume(const FractalFrame& frame)
+{
+  setName(frame.name());
+  Fractal::setDiverge(frame.diverge());
+  Fractal::setJulia(frame.julia());
+  Fractal::setJuliaExponent(frame.juliaExponent());
+  
+  m_fractalControl.setView(frame);
+  
+  // The fractal is rendered when the axes are set.
+  {
+    const QSignalBlocker blocker(m_fractalEdit);
+    m_fractalEdit->setCurrentIndex(
+      m_fractalEdit->findText(QString::fromStdString(name())));
+  }
+  
+  m_divergeEdit->setText(QString::number(diverge()));
+  m_juliaEdit->setText(
+    QString::number(julia().real()) + "," + QString::number(julia().imag()));
+  m_juliaExponentEdit->setText(QString::number(juliaExponent()));
+  
+  setIntervals();
+}
+
 void FractalWidget::save()
 {
   QSettings settings;
@@ -270,6 +324,26 @@ void FractalWidget::save()
   settings.setValue("julia imag", julia().imag());
   settings.setValue("diverge", diverge());
   settings.setValue("dir", m_fractalControl.geo().dir().absolutePath());
+  settings.setValue("threads", m_fractalRenderer.threads());
+  settings.setValue("cache", (qulonglong)m_fractalRenderer.cacheSize() / (1024 * 1024));
+  settings.setValue("cache dir", m_fractalRenderer.cacheDir());
+  settings.setValue("cache disk", (qulonglong)m_fractalRenderer.cacheDisk() / (1024 * 1024));
+  settings.setValue("checkpoint", m_fractalRenderer.checkpointInterval());
+  settings.setValue("debounce", m_fractalRenderer.debounce());
+}
+
+void FractalWidget::saveFrame()
+{
+  const QString file(QFileDialog::getSaveFileName(this, "Save Frame",
+    QString(), "Frames (*.frame)"));
+  
+  if (file.isEmpty())
+  {
+    return;
+  }
+  
+  m_statusBar->showMessage(m_fractalRenderer.saveFrame(file) ?
+    "saved " + file: "could not save " + file + ", rendering is not ready");
 }
 
 void FractalWidget::setAxes(int state)
@@ -399,15 +473,29 @@ void FractalWidget::setSize()
   }
 }
 
-void FractalWidget::updatePixmap(const QImage image, int state)
+void FractalWidget::updateImage(int state, int generation)
 {
+  // Images queued before the last render request are dropped.
+  if (generation != m_fractalRenderer.generation())
+  {
+    return;
+  }
+  
   m_updates++;
   m_updatesLabel->setText(QString::number(m_updates));
     
   if (state == RENDERING_READY)
   {
     m_progressBar->hide();
-    m_statusBar->showMessage("ready");
+    const auto& stats(m_fractalRenderer.stats());
+    
+    m_statusBar->showMessage(
+      QString("ready (%1), interior: cardioid %2, bulb %3, cycle %4, guessed %5%")
+        .arg(Fractal::precisionName(m_fractalRenderer.precision()))
+        .arg(stats.count(FractalStats::SHORTCUT_CARDIOID))
+        .arg(stats.count(FractalStats::SHORTCUT_BULB))
+        .arg(stats.count(FractalStats::SHORTCUT_CYCLE))
+        .arg(100 * m_fractalRenderer.guessed(), 0, 'f', 1));
       
     if (m_autoZoom >= 0)
     {
@@ -426,7 +514,8 @@ void FractalWidget::updatePixmap(const QImage image, int state)
     m_statusBar->showMessage("refreshed", 50);
   }
     
-  m_fractalPixmap = QPixmap::fromImage(image);
+  // The image is drawn as it is, without converting it to a pixmap.
+  m_fractalImage = m_fractalRenderer.image();
   
   replot();
 }
@@ -438,23 +527,25 @@ void FractalWidget::updateProgress(int line, int /*max */)
 
 void FractalWidget::zoom(double factor)
 {
-  const QPointF center = m_zoom->zoomRect().center();
-  const double width = m_zoom->zoomRect().width() * factor;
-  const double height = m_zoom->zoomRect().height() * factor;
-  
-  const QRectF r(
-    center.x() - width / 2.0, 
-    center.y() - height / 2.0,
-    width, 
-    height); 
-    
-  m_zoom->zoom(r);
+  // The view is zoomed in full precision, the zoomer
+  // gets the approximation for the axes.
+  m_fractalControl.geo().zoom(factor);
+  
+  const FractalInterval x(m_fractalControl.geo().intervalX());
+  const FractalInterval y(m_fractalControl.geo().intervalY());
+  
+  m_zoom->zoom(QRectF(x.minValue(), y.minValue(), x.width(), y.width()));
 }
 
 void FractalWidget::zoomed()
 {
-  // Just render, might restore pixmaps from cache if we are zooming back
-  // or forward to recently rendered fractal,
-  // so rendering would not be necessary.
+  // Just render, the renderer restores the frame from its cache
+  // if we are zooming back or forward to a recently rendered fractal,
+  // so calculation is not necessary.
   render();  
 }
+
+void FractalWidget::zoomedPart(const QRectF& part)
+{
+  m_fractalControl.geo().zoom(part);
+}
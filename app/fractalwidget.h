@@ -2,7 +2,7 @@
 // Name:      fractalwidget.h
 // Purpose:   Declaration of class FractalWidget
 // Author:    Anton van Wezenbeek
-// Copyright: (c) 2017 Anton van Wezenbeek
+// Copyright: (c) 2017-2026 Anton van Wezenbeek
 ////////////////////////////////////////////////////////////////////////////////
 
 #pragma once
@@ -10,8 +10,8 @@
 #include <QCheckBox>
 #include <QComboBox>
 #include <QLabel>
+#include <QImage>
 #include <QLineEdit>
-#include <QPixmap>
 #include <QProgressBar>
 #include <QStatusBar>
 #include <QToolBar>
@@ -79,12 +79,16 @@ public:
   /// Access to fractal control.
   const auto & fractalControl() const {return m_fractalControl;};
   
-  /// Access to fractal pixmap.
-  const auto & fractalPixmap() const {return m_fractalPixmap;};
+  /// Access to fractal image, shared with the renderer.
+  const auto & fractalImage() const {return m_fractalImage;};
   
   /// Access to renderer.
   auto * renderer() {return &m_fractalRenderer;};
   
+  /// Resumes the fractal and view of a frame, e.g. a checkpoint
+  /// (see FractalRenderer::setCheckpoint).
+  void resume(const FractalFrame& frame);
+  
 public slots:
   /// Zooms in a number of times.
   void autoZoom();
@@ -97,10 +101,17 @@ public slots:
   
   /// Double clicked.
   bool doubleClicked();
+  
+  /// Opens a frame file, and shows its image
+  /// (see FractalRenderer::setFrame).
+  void openFrame();
  
   /// Saves settings.
   void save();
   
+  /// Saves the frame of the image to a file.
+  void saveFrame();
+  
   /// Zooms in.
   void zoomIn() {zoom(0.9);};
 
@@ -119,16 +130,17 @@ private slots:
   void setJulia();
   void setJuliaExponent(const QString& text);
   void setSize();
-  void updatePixmap(const QImage image, int state);
+  void updateImage(int state, int generation);
   void updateProgress(int line, int max);
   void zoomed();
+  void zoomedPart(const QRectF& part);
 private:
   void init(bool show_axes);
   void zoom(double factor);
 
   FractalControl m_fractalControl;
   FractalRenderer m_fractalRenderer;
-  QPixmap m_fractalPixmap = QPixmap(100, 100);
+  QImage m_fractalImage;
   
   QCheckBox* m_axesEdit;
   QComboBox* m_fractalEdit;
@@ -2,7 +2,7 @@
 // Name:      mainwindow.cpp
 // Purpose:   Implementation of class MainWindow
 // Author:    Anton van Wezenbeek
-// Copyright: (c) 2017 Anton van Wezenbeek
+// Copyright: (c) 2017-2026 Anton van Wezenbeek
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <QtGui>
@@ -10,8 +10,10 @@
 #include <QMenu>
 #include <QPushButton>
 #include <QSettings>
+#include <QStandardPaths>
 #include <qwt_global.h>
 #include "mainwindow.h"
+#include "fractalsimd.h"
 #include "fractalwidget.h"
 
 void menuItem(QMenu* menu, 
@@ -76,6 +78,21 @@ MainWindow::MainWindow(QWidget* parent, FractalWidget* fw)
     resize(QSize(300, 300)); // initial size
       
     restoreGeometry(settings.value("mainWindowGeometry").toByteArray());
+    
+    // An image that was not finished continues from its checkpoint.
+    const QString dir(
+      QStandardPaths::writableLocation(QStandardPaths::AppDataLocation));
+    QDir().mkpath(dir);
+    FractalFrame frame;
+    
+    if (frame.load(QDir(dir).filePath("checkpoint.frame")))
+    {
+      m_fractalWidget->resume(frame);
+    }
+    
+    m_fractalWidget->renderer()->setCheckpoint(
+      QDir(dir).filePath("checkpoint.frame"),
+      settings.value("checkpoint", 60).toInt());
   }
     
   qRegisterMetaType<QImage>("QImage");
@@ -90,6 +107,8 @@ MainWindow::MainWindow(QWidget* parent, FractalWidget* fw)
   menuItem(menu, "Colours From End...", &m_fractalWidget->fractalControl(), SLOT(setColoursDialogEnd()), QKeySequence(), true);
   menuItem(menu, "Images...", &m_fractalWidget->fractalControl(), SLOT(setImages()), QKeySequence(), true);
   menuItem(menu, "Copy", m_fractalWidget, SLOT(copy()), QKeySequence::Copy);
+  menuItem(menu, "Open Frame...", m_fractalWidget, SLOT(openFrame()), QKeySequence::Open);
+  menuItem(menu, "Save Frame...", m_fractalWidget, SLOT(saveFrame()), QKeySequence::SaveAs, true);
   menuItem(menu, "Refresh", m_fractalWidget->renderer(), SLOT(refresh()), QKeySequence::Refresh);
   menuItem(menu, "Restart", m_fractalWidget->renderer(), SLOT(restart()), QKeySequence("Ctrl+R"), true);
   menuItem(menu, "Zoom In", m_fractalWidget, SLOT(zoomIn()), QKeySequence("Ctrl+Z"));
@@ -120,6 +139,17 @@ MainWindow::MainWindow(QWidget* parent, FractalWidget* fw)
   setCentralWidget(m_fractalWidget);
   setWindowTitle("Fractal Map");
   
+  m_fractalWidget->renderer()->setThreads(
+    QSettings().value("threads", 0).toInt());
+  m_fractalWidget->renderer()->setCacheSize(
+    QSettings().value("cache", 64).toULongLong() * 1024 * 1024);
+  m_fractalWidget->renderer()->setCacheDisk(
+    QSettings().value("cache dir", 
+      QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).toString(),
+    QSettings().value("cache disk", 256).toULongLong() * 1024 * 1024);
+  m_fractalWidget->renderer()->setDebounce(
+    QSettings().value("debounce", 50).toInt());
+  m_fractalWidget->renderer()->setKeepOrbits(true);
   m_fractalWidget->renderer()->start();
 }
 
@@ -127,9 +157,10 @@ void MainWindow::about()
 {
   QMessageBox::about(this, 
     "About " + windowTitle(),
-    QString("This application shows a fractal map.\nBuilt using Qt %1 and Qwt %2")
+    QString("This application shows a fractal map.\nBuilt using Qt %1 and Qwt %2\nUsing %3 kernels")
       .arg(QT_VERSION_STR)
-      .arg(QWT_VERSION_STR));
+      .arg(QWT_VERSION_STR)
+      .arg(FractalSimd::isaName()));
 }
 
 void MainWindow::closeEvent(QCloseEvent* /* event */) 
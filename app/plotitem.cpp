@@ -2,7 +2,7 @@
 // Name:      plotitem.cpp
 // Purpose:   Implementation of class FractalPlotItem
 // Author:    Anton van Wezenbeek
-// Copyright: (c) 2012 Anton van Wezenbeek
+// Copyright: (c) 2012-2026 Anton van Wezenbeek
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <QtGui>
@@ -24,7 +24,7 @@ void FractalPlotItem::draw(QPainter *p,
 {
   const FractalWidget* fw = (FractalWidget *)plot();
   
-  QwtPainter::drawPixmap(p, r, fw->fractalPixmap());
+  QwtPainter::drawImage(p, r, fw->fractalImage());
 }
 
 int FractalPlotItem::rtti() const
@@ -9,6 +9,7 @@
 #include <QEvent>
 #include <qwt_plot_canvas.h>
 #include <qwt_plot_layout.h>
+#include <qwt_scale_map.h>
 #include <qwt_scale_engine.h>
 #include <qwt_scale_widget.h>
 
@@ -16,8 +17,11 @@
 #include "fractalwidget.h"
 #include "scrollbar.h"
 
-PlotZoomer::PlotZoomer(QWidget* widget, QStatusBar* bar, bool doReplot)
+PlotZoomer::PlotZoomer(
+  QWidget* widget, QStatusBar* bar, FractalGeometry& geo, bool doReplot)
   : QwtPlotZoomer(widget, doReplot)
+  , m_geo(geo)
+  , m_views({view()})
   , m_cornerWidget( new QWidget( canvas() ))
   , m_hScrollBar( new ScrollBar( ScrollBar::AttachedToScale, Qt::Horizontal, canvas() ))
   , m_vScrollBar( new ScrollBar( ScrollBar::OppositeToScale, Qt::Vertical, canvas() ))
@@ -49,6 +53,32 @@ PlotZoomer::PlotZoomer(QWidget* widget, QStatusBar* bar, bool doReplot)
   updateScrollBars();
 }
 
+bool PlotZoomer::end(bool ok)
+{
+  // The selection in pixels gives the part of the view,
+  // so the view can be zoomed beyond the precision of the axes.
+  if (ok)
+  {
+    QPolygon pa(selection());
+    
+    if (accept(pa))
+    {
+      const QRectF r(QRect(pa[0], pa[int(pa.count()) - 1]).normalized());
+      const QwtScaleMap xMap(plot()->canvasMap(xAxis()));
+      const QwtScaleMap yMap(plot()->canvasMap(yAxis()));
+      
+      // the y map has its minimum at the bottom
+      emit zoomedPart(QRectF(
+        (r.left() - xMap.p1()) / (xMap.p2() - xMap.p1()),
+        (r.top() - yMap.p2()) / (yMap.p1() - yMap.p2()),
+        r.width() / (xMap.p2() - xMap.p1()),
+        r.height() / (yMap.p1() - yMap.p2())));
+    }
+  }
+  
+  return QwtPlotZoomer::end(ok);
+}
+
 void PlotZoomer::layoutScrollBars( const QRect &rect )
 {
   int hPos = xAxis();
@@ -114,10 +144,35 @@ void PlotZoomer::layoutScrollBars( const QRect &rect )
 
 QSizeF PlotZoomer::minZoomSize() const
 {
-  // default uses 10e4
+  // default uses 10e4, the limit is where the axes in double precision
+  // cannot resolve the pixels anymore, the view zooms on beyond it
+  // (see zoom), only the zoom stack stops there
   return QSizeF(
-    zoomStack()[0].width() / 10e6,
-    zoomStack()[0].height() / 10e6);
+    zoomStack()[0].width() / 1e12,
+    zoomStack()[0].height() / 1e12);
+}
+
+void PlotZoomer::moveTo(const QPointF& pos)
+{
+  const QRectF from(zoomRect());
+  
+  QwtPlotZoomer::moveTo(pos);
+  
+  const QRectF to(zoomRect());
+  
+  if (to == from)
+  {
+    return;
+  }
+  
+  // As fractions of the view, as zoomedPart, the imag axis points up.
+  m_geo.zoom(QRectF(
+    (to.left() - from.left()) / from.width(),
+    -(to.top() - from.top()) / from.height(), 
+    1, 
+    1));
+  
+  m_views[zoomRectIndex()] = view();
 }
 
 bool PlotZoomer::needScrollBar( Qt::Orientation orientation ) const
@@ -251,6 +306,13 @@ void PlotZoomer::scrollBarValueChanged(
   emit zoomed( zoomRect() );
 }
 
+void PlotZoomer::setZoomBase(bool doReplot)
+{
+  QwtPlotZoomer::setZoomBase(doReplot);
+  
+  m_views = {view()};
+}
+
 QwtText PlotZoomer::trackerTextF( const QPointF &pos ) const
 {
   QString text;
@@ -338,6 +400,11 @@ void PlotZoomer::updateScrollBars()
   plot()->updateLayout();
 }
 
+PlotZoomer::View PlotZoomer::view() const
+{
+  return {m_geo.centerX(), m_geo.centerY(), m_geo.width(), m_geo.height()};
+}
+
 void PlotZoomer::widgetKeyPressEvent(QKeyEvent* event)
 {
   if (
@@ -424,3 +491,36 @@ void PlotZoomer::widgetMouseReleaseEvent(QMouseEvent* event)
     m_vScrollBar->setValue(m_vScrollBar->value() - y);
   }
 }
+
+void PlotZoomer::zoom(const QRectF& rect)
+{
+  const auto index = zoomRectIndex();
+  
+  QwtPlotZoomer::zoom(rect);
+  
+  if (zoomRectIndex() != index)
+  {
+    m_views.resize(index + 1);
+    m_views.push_back(view());
+  }
+  else
+  {
+    // The axes cannot resolve the view anymore, it replaces
+    // the view of this entry.
+    m_views[index] = view();
+    emit zoomed(zoomRect());
+  }
+}
+
+void PlotZoomer::zoom(int offset)
+{
+  // The view is restored before the zoomer emits zoomed.
+  const int index = (offset == 0 ? 0: qBound(
+    0, (int)zoomRectIndex() + offset, (int)zoomStack().size() - 1));
+  
+  m_geo.setView(
+    m_views[index].m_centerX, m_views[index].m_centerY,
+    m_views[index].m_width, m_views[index].m_height);
+  
+  QwtPlotZoomer::zoom(offset);
+}
@@ -7,24 +7,51 @@
 
 #pragma once 
 
+#include <vector>
 #include <QtGui>
 #include <QStatusBar>
 #include <qglobal.h>
 #include <qwt_plot.h>
 #include <qwt_plot_zoomer.h>
+#include "fractalgeometry.h"
 
 class ScrollBar;
 
 /// This class offers facility to zoom in on the plot.
+/// The zoom stack keeps the view of the geometry for each entry,
+/// in full precision, the rectangles of the stack approximate them
+/// for the axes.
 class PlotZoomer: public QwtPlotZoomer
 {
   Q_OBJECT
 
 public:
   /// Constructor.
-  PlotZoomer(QWidget* widget, QStatusBar* bar, bool doReplot = true);
+  PlotZoomer(QWidget* widget, QStatusBar* bar, FractalGeometry& geo, 
+    bool doReplot = true);
+
+  /// Moves the view to a position of the axes, the view is moved
+  /// by the same fraction of it as the zoom rectangle.
+  virtual void moveTo(const QPointF& pos) override;
+
+  /// Sets the zoom stack to the current view.
+  virtual void setZoomBase(bool doReplot = true) override;
+
+  /// Zooms to a rectangle, after the view is zoomed in full precision
+  /// (see zoomedPart). If the axes cannot resolve the rectangle, 
+  /// the zoom stack does not change, but the view did.
+  virtual void zoom(const QRectF& rect) override;
+
+  /// Zooms back or forward in the zoom stack, restoring its view.
+  virtual void zoom(int offset) override;
+
+signals:
+  /// Emitted before zooming into a selected part of the view,
+  /// as fractions of the view, (0,0) being the top left.
+  void zoomedPart(const QRectF& part);
   
 protected:  
+  virtual bool end(bool ok = true) override;
   virtual QSizeF minZoomSize() const override;
   virtual void rescale() override;
   virtual QwtText trackerTextF( const QPointF & ) const override;
@@ -37,10 +64,21 @@ private slots:
   void scrollBarValueChanged( Qt::Orientation, double, double );
 
 private:
+  // the view of the geometry
+  struct View
+  {
+    BigReal m_centerX, m_centerY;
+    double m_width, m_height;
+  };
+
   void layoutScrollBars( const QRect & );
   bool needScrollBar( Qt::Orientation ) const;
   int oppositeAxis( int ) const;
   void updateScrollBars();
+  View view() const;
+
+  FractalGeometry& m_geo;
+  std::vector<View> m_views;
 
   QWidget* m_cornerWidget;
   ScrollBar* m_hScrollBar;
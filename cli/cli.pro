@@ -0,0 +1,17 @@
+################################################################################
+# Name:      cli.pro
+# Purpose:   Qt project file of the batch renderer
+# Author:    Anton van Wezenbeek
+# Copyright: (c) 2026 Anton van Wezenbeek
+################################################################################
+
+TEMPLATE = app
+TARGET = fractal-cli
+QT = core gui
+CONFIG += console
+CONFIG -= app_bundle
+
+include ( ../core/core.pri )
+
+SOURCES += \
+  main.cpp
@@ -0,0 +1,404 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      main.cpp
+// Purpose:   main for fractal-cli, the batch renderer
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QTextStream>
+#include "bigtiff.h"
+#include "fractalrenderer.h"
+
+// The memory of a pixel in a strip, three image buffers, the counts
+// of two frames while the next strip is set up, and the strip, 
+// strips do not keep orbits.
+const int bytes_per_pixel = 32;
+
+// Returns the geometry of rows of the image, starting at row.
+static FractalGeometry band(
+  const FractalGeometry& geo, const QSize& size, int row, int rows)
+{
+  FractalGeometry band(geo);
+  const double dy = -((row + rows / 2.0) / size.height() - 0.5) * geo.height();
+
+  band.setView(
+    geo.centerX(),
+    geo.centerY() + BigReal(dy, geo.centerY().limbs()),
+    geo.width(),
+    geo.height() * rows / size.height());
+
+  return band;
+}
+
+static QStringList imageFiles(const QString& dir)
+{
+  // The dir setting of the browser is the first image selected.
+  const QDir images(QFileInfo(dir).isDir() ?
+    dir: QFileInfo(dir).absolutePath());
+
+  QStringList files;
+
+  for (const auto & i : images.entryList(
+    {"*.bmp", "*.gif", "*.ico", "*.jpg", "*.png", "*.xpm"}, QDir::Files))
+  {
+    files << images.absoluteFilePath(i);
+  }
+
+  return files;
+}
+
+// Writes the iteration counts, for each row of steps a row
+// of 32 bit counts in native byte order.
+static bool writeCounts(const FractalFrame& frame, const QString& file)
+{
+  QFile raw(file);
+
+  if (!raw.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+
+  const QSize& inc(frame.inc());
+  std::vector<qint32> row;
+
+  for (int y = 0; y < frame.size().height(); y += inc.height())
+  {
+    row.clear();
+
+    for (int x = 0; x < frame.size().width(); x += inc.width())
+    {
+      row.push_back(frame.count(QPoint(x, y)));
+    }
+
+    const qint64 bytes = row.size() * sizeof(qint32);
+
+    if (raw.write((const char*)row.data(), bytes) != bytes)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  QCoreApplication::setOrganizationName("Coffee Tigers");
+  QCoreApplication::setApplicationName("fractal-map");
+
+  // The defaults are the settings of the fractal browser.
+  QSettings settings;
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(
+    "Renders a fractal into a file, without display. "
+    "The defaults are taken from the settings of the fractal browser.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("file",
+    "the image file, its suffix selects the format (e.g. png), "
+    "a tif file is rendered in strips and resumed if partial, "
+    "a raw file gets the iteration counts, "
+    "a frame file gets the frame in native format");
+
+  const QCommandLineOption checkpoint("checkpoint",
+    "checkpoint file, an image that was not finished continues from it",
+    "file");
+  const QCommandLineOption checkpointInterval("checkpoint-interval",
+    "checkpoint interval in seconds", "seconds", "60");
+  const QCommandLineOption colours({"c", "colours"},
+    "number of colours", "n", settings.value("colours", 128).toString());
+  const QCommandLineOption depth({"d", "depth"},
+    "iteration depth", "n", settings.value("depth", 64).toString());
+  const QCommandLineOption dir("dir",
+    "dir with images, used with images", "dir",
+    settings.value("dir", "").toString());
+  const QCommandLineOption diverge("diverge",
+    "diverge limit", "value", settings.value("diverge", 2).toString());
+  const QCommandLineOption fractal({"f", "fractal"},
+    "the fractal", "name",
+    settings.value("fractal", "julia set 4").toString());
+  const QCommandLineOption frame("frame",
+    "frame file in native format, its fractal, view and size are used, "
+    "with a higher depth it is continued", "file");
+  const QCommandLineOption guess({"g", "guess"}, "guess solid areas");
+  const QCommandLineOption images("images",
+    "use the images in dir instead of colours");
+  const QCommandLineOption intervals({"i", "intervals"},
+    "the view", "x1,x2,y1,y2", "-2,2,-2,2");
+  const QCommandLineOption juliaExponent("julia-exponent",
+    "julia exponent", "value",
+    settings.value("julia exponent", 2).toString());
+  const QCommandLineOption juliaImag("julia-imag",
+    "julia imag", "value", settings.value("julia imag", 1.1).toString());
+  const QCommandLineOption juliaReal("julia-real",
+    "julia real", "value", settings.value("julia real", 0.9).toString());
+  const QCommandLineOption memory({"m", "memory"},
+    "memory budget in MB for rendering a tif file", "MB", "256");
+  const QCommandLineOption size({"s", "size"},
+    "image size", "width,height", "1920,1080");
+  const QCommandLineOption threads({"t", "threads"},
+    "number of threads, 0 uses all cores", "n",
+    settings.value("threads", 0).toString());
+
+  parser.addOptions({checkpoint, checkpointInterval, colours, depth, dir,
+    diverge, fractal, frame, guess, images, intervals, juliaExponent,
+    juliaImag, juliaReal, memory, size, threads});
+  parser.process(app);
+
+  QTextStream out(stdout);
+  QTextStream err(stderr);
+
+  if (parser.positionalArguments().size() != 1)
+  {
+    parser.showHelp(1);
+  }
+
+  const QString file(parser.positionalArguments()[0]);
+  const QStringList sl(parser.value(size).split(","));
+  const QStringList il(parser.value(intervals).split(","));
+
+  if (sl.size() != 2 || il.size() != 4)
+  {
+    err << "size or intervals not ok\n";
+    return 1;
+  }
+
+  QSize imageSize(sl[0].toInt(), sl[1].toInt());
+
+  Fractal f(
+    parser.value(fractal).toStdString(),
+    parser.value(diverge).toDouble(),
+    std::complex<double>(
+      parser.value(juliaReal).toDouble(),
+      parser.value(juliaImag).toDouble()),
+    parser.value(juliaExponent).toDouble());
+
+  FractalGeometry geo(
+    FractalInterval(il[0].toDouble(), il[1].toDouble()),
+    FractalInterval(il[2].toDouble(), il[3].toDouble()),
+    parser.value(depth).toInt(),
+    parser.value(dir));
+
+  // No previews are needed, the image is rendered in one pass.
+  geo.setColours(parser.value(colours).toInt());
+  geo.setGuess(parser.isSet(guess));
+  geo.setPasses(1);
+
+  if (parser.isSet(images))
+  {
+    if (!geo.setImages(imageFiles(parser.value(dir))))
+    {
+      err << "no images in " << parser.value(dir) << "\n";
+      return 1;
+    }
+
+    geo.setUseImages(true);
+  }
+
+  FractalFrame opened;
+
+  if (parser.isSet(frame))
+  {
+    if (!opened.open(parser.value(frame)))
+    {
+      err << "could not open " << parser.value(frame) << "\n";
+      return 1;
+    }
+
+    // The frame is only coloured, or continued at the depth set.
+    f = Fractal(opened.name(), opened.diverge(), opened.julia(), 
+      opened.juliaExponent());
+    geo.setView(
+      opened.centerX(), opened.centerY(), opened.width(), opened.height());
+    geo.setGuess(opened.guess());
+
+    if (!parser.isSet(depth))
+    {
+      geo.setDepth(opened.depth());
+    }
+
+    imageSize = opened.size();
+  }
+
+  if (imageSize.isEmpty() || !f.isOk() || !geo.isOk())
+  {
+    err << "parameters not ok\n";
+    return 1;
+  }
+
+  // A tif file is written in strips, each strip is rendered as an image 
+  // of its own, so memory does not depend on the height of the image.
+  const QString suffix(QFileInfo(file).suffix().toLower());
+  const bool strips = (suffix == "tif" || suffix == "tiff");
+  BigTiff tiff;
+
+  if (strips)
+  {
+    if (parser.isSet(frame))
+    {
+      err << "a frame is not rendered in strips\n";
+      return 1;
+    }
+
+    // A partial file is only resumed with the same parameters.
+    const QString description(QStringList({
+      "fractal " + parser.value(fractal),
+      "diverge " + parser.value(diverge),
+      "julia " + parser.value(juliaReal) + "," + parser.value(juliaImag),
+      "exponent " + parser.value(juliaExponent),
+      "intervals " + parser.value(intervals),
+      "depth " + parser.value(depth),
+      "colours " + parser.value(colours),
+      "guess " + QString::number(parser.isSet(guess)),
+      "images " + (parser.isSet(images) ? parser.value(dir): QString())}).join(", "));
+
+    int rows = std::max<qint64>(1, parser.value(memory).toLongLong() * 1024 * 1024 /
+      ((qint64)imageSize.width() * bytes_per_pixel));
+
+    // Images are stamped whole, a strip has whole images.
+    if (geo.useImages())
+    {
+      const int h = geo.image(0).height();
+      rows = std::max(1, rows / h) * h;
+    }
+
+    if (!tiff.open(file, imageSize, rows, description))
+    {
+      err << "could not write " << file << "\n";
+      return 1;
+    }
+
+    if (tiff.isFinished())
+    {
+      out << file << " is finished\n";
+      return 0;
+    }
+
+    if (tiff.strip() > 0)
+    {
+      out << "resuming " << file << " at strip " << tiff.strip() << "\n";
+    }
+  }
+
+  FractalRenderer renderer;
+  renderer.setCacheSize(0);
+  renderer.setThreads(parser.value(threads).toInt());
+  
+  // Only a frame file is continued later, e.g. at a higher depth.
+  renderer.setKeepOrbits(suffix == "frame");
+  renderer.setFrame(opened);
+  
+  if (parser.isSet(checkpoint))
+  {
+    if (QFileInfo::exists(parser.value(checkpoint)))
+    {
+      out << "using checkpoint " << parser.value(checkpoint) << "\n";
+    }
+    
+    renderer.setCheckpoint(
+      parser.value(checkpoint), parser.value(checkpointInterval).toInt());
+  }
+
+  QElapsedTimer timer;
+  FractalStats stats;
+  double pixels = 0;
+  double guessed = 0;
+
+  const auto renderStrip = [&]() {
+    const int row = tiff.strip() * tiff.rows();
+    const int rows = tiff.rowsToWrite();
+
+    renderer.render(f, QSize(imageSize.width(), rows),
+      band(geo, imageSize, row, rows));};
+
+  QObject::connect(&renderer, &FractalRenderer::rendered, &app,
+    [&](int state, int) {
+      if (state != RENDERING_READY)
+      {
+        return;
+      }
+
+      const double rendered = 
+        (double)renderer.frame().size().width() * renderer.frame().size().height();
+
+      for (int i = 0; i < FractalStats::SHORTCUT_MAX; i++)
+      {
+        stats.add((FractalStats::Shortcut)i, 
+          renderer.stats().count((FractalStats::Shortcut)i));
+      }
+
+      pixels += rendered;
+      guessed += renderer.guessed() * rendered;
+
+      if (strips)
+      {
+        if (!tiff.write(renderer.image()))
+        {
+          err << "could not write " << file << "\n";
+          app.exit(1);
+          return;
+        }
+
+        if (!tiff.isFinished())
+        {
+          out << "strip " << tiff.strip() << "/" << tiff.strips() << "\r";
+          out.flush();
+          renderStrip();
+          return;
+        }
+      }
+
+      const double seconds = timer.nsecsElapsed() / 1e9;
+
+      out << f.name().c_str() << " "
+          << imageSize.width() << "x" << imageSize.height()
+          << " depth " << geo.depth() << "\n"
+          << "precision:  " <<
+             Fractal::precisionName(renderer.precision()) << "\n"
+          << "time:       " << seconds << " s\n"
+          << "throughput: " << pixels / seconds / 1e6 << " Mpixels/s\n"
+          << "cardioid:   " << stats.count(FractalStats::SHORTCUT_CARDIOID) << "\n"
+          << "bulb:       " << stats.count(FractalStats::SHORTCUT_BULB) << "\n"
+          << "cycle:      " << stats.count(FractalStats::SHORTCUT_CYCLE) << "\n"
+          << "guessed:    " << guessed / pixels * 100 << " %\n";
+      out.flush();
+
+      const bool ok = (strips || 
+        (suffix == "raw" ? writeCounts(renderer.frame(), file):
+         suffix == "frame" ? renderer.frame().save(file):
+         renderer.image().save(file)));
+
+      if (!ok)
+      {
+        err << "could not write " << file << "\n";
+      }
+
+      app.exit(ok ? 0: 1);});
+
+  // The request is made before the process is started, so the first
+  // image rendered is this one.
+  timer.start();
+
+  if (strips)
+  {
+    renderStrip();
+  }
+  else
+  {
+    renderer.render(f, imageSize, geo);
+  }
+
+  renderer.start();
+
+  return app.exec();
+}
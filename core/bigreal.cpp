@@ -0,0 +1,328 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      bigreal.cpp
+// Purpose:   Implementation of class BigReal
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include "bigreal.h"
+
+BigReal::BigReal(double value, int limbs)
+  : m_limbs(int_limbs + std::max(0, limbs), 0)
+  , m_negative(value < 0)
+{
+  double v = std::fabs(value);
+
+  // Takes the limbs from the top, each subtraction is exact.
+  for (size_t i = 0; i < m_limbs.size() && v > 0; i++)
+  {
+    const int exp = 32 * (int_limbs - 1 - (int)i);
+    const double limb = std::floor(std::ldexp(v, -exp));
+
+    m_limbs[i] = (uint32_t)std::min(limb, 4294967295.0);
+    v -= std::ldexp((double)m_limbs[i], exp);
+  }
+}
+
+BigReal BigReal::add(const BigReal& a, const BigReal& b, bool negate)
+{
+  const int limbs = std::max(a.limbs(), b.limbs());
+
+  BigReal x(a);
+  BigReal y(b);
+  x.setLimbs(limbs);
+  y.setLimbs(limbs);
+
+  if (negate)
+  {
+    y.m_negative = !y.m_negative;
+  }
+
+  BigReal r(0, limbs);
+
+  if (x.m_negative == y.m_negative)
+  {
+    uint64_t carry = 0;
+
+    for (int i = (int)r.m_limbs.size() - 1; i >= 0; i--)
+    {
+      const uint64_t t = (uint64_t)x.m_limbs[i] + y.m_limbs[i] + carry;
+      r.m_limbs[i] = (uint32_t)t;
+      carry = t >> 32;
+    }
+
+    r.m_negative = x.m_negative;
+  }
+  else
+  {
+    // subtract the smaller magnitude from the larger one
+    const bool swap = compare(x.m_limbs, y.m_limbs) < 0;
+    const BigReal& big(swap ? y: x);
+    const BigReal& small(swap ? x: y);
+
+    int64_t borrow = 0;
+
+    for (int i = (int)r.m_limbs.size() - 1; i >= 0; i--)
+    {
+      int64_t t = (int64_t)big.m_limbs[i] - small.m_limbs[i] - borrow;
+      borrow = (t < 0);
+
+      if (t < 0)
+      {
+        t += ((int64_t)1 << 32);
+      }
+
+      r.m_limbs[i] = (uint32_t)t;
+    }
+
+    r.m_negative = big.m_negative;
+  }
+
+  if (r.isZero())
+  {
+    r.m_negative = false;
+  }
+
+  return r;
+}
+
+int BigReal::compare(
+  const std::vector<uint32_t>& a, const std::vector<uint32_t>& b)
+{
+  for (size_t i = 0; i < std::max(a.size(), b.size()); i++)
+  {
+    const uint32_t x = (i < a.size() ? a[i]: 0);
+    const uint32_t y = (i < b.size() ? b[i]: 0);
+
+    if (x != y)
+    {
+      return x < y ? -1: 1;
+    }
+  }
+
+  return 0;
+}
+
+void BigReal::divide(uint32_t value)
+{
+  uint64_t rest = 0;
+
+  for (auto& limb : m_limbs)
+  {
+    const uint64_t t = (rest << 32) | limb;
+    limb = (uint32_t)(t / value);
+    rest = t % value;
+  }
+}
+
+BigReal BigReal::fromString(const std::string& text, int limbs)
+{
+  BigReal r(0, limbs);
+
+  size_t pos = 0;
+  bool negative = false;
+
+  if (pos < text.size() && (text[pos] == '-' || text[pos] == '+'))
+  {
+    negative = (text[pos] == '-');
+    pos++;
+  }
+
+  const size_t point = text.find('.', pos);
+  const size_t end = text.find_first_not_of("0123456789",
+    point == std::string::npos ? pos: point + 1);
+  const std::string integer(text.substr(pos,
+    (point == std::string::npos ? end: point) - pos));
+  const std::string fraction(point == std::string::npos ?
+    std::string(): text.substr(point + 1, end - point - 1));
+
+  // fraction, from the last digit: f = (f + d) / 10
+  for (auto it = fraction.rbegin(); it != fraction.rend(); ++it)
+  {
+    r.m_limbs[int_limbs - 1] += (uint32_t)(*it - '0');
+    r.divide(10);
+  }
+
+  // integer part fits in the integer limbs
+  uint64_t value = 0;
+
+  for (const auto c : integer)
+  {
+    if (!std::isdigit((unsigned char)c))
+    {
+      break;
+    }
+
+    value = value * 10 + (c - '0');
+  }
+
+  r.m_limbs[0] = (uint32_t)(value >> 32);
+  r.m_limbs[1] = (uint32_t)value;
+  r.m_negative = negative && !r.isZero();
+
+  return r;
+}
+
+bool BigReal::isZero() const
+{
+  return std::all_of(m_limbs.begin(), m_limbs.end(),
+    [](uint32_t l) {return l == 0;});
+}
+
+int BigReal::limbsFor(double resolution)
+{
+  if (resolution <= 0 || !std::isfinite(resolution))
+  {
+    return 2;
+  }
+
+  // two guard limbs, for errors growing during iterations
+  return std::max(2, (int)std::ceil(-std::log2(resolution) / 32) + 2);
+}
+
+void BigReal::setLimbs(int limbs)
+{
+  m_limbs.resize(int_limbs + std::max(0, limbs), 0);
+
+  if (isZero())
+  {
+    m_negative = false;
+  }
+}
+
+double BigReal::toDouble() const
+{
+  const auto first = std::find_if(m_limbs.begin(), m_limbs.end(),
+    [](uint32_t l) {return l != 0;});
+
+  double r = 0;
+
+  // three limbs are more than the 53 bits of a double
+  for (auto it = first; it != m_limbs.end() && it < first + 3; ++it)
+  {
+    const int exp = 32 * (int_limbs - 1 - (int)(it - m_limbs.begin()));
+    r += std::ldexp((double)*it, exp);
+  }
+
+  return m_negative ? -r: r;
+}
+
+std::string BigReal::toString(int digits) const
+{
+  const uint64_t integer = ((uint64_t)m_limbs[0] << 32) | m_limbs[1];
+
+  std::string text((m_negative ? "-": "") + std::to_string(integer));
+
+  if (digits > 0)
+  {
+    text += ".";
+
+    std::vector<uint32_t> fraction(m_limbs.begin() + int_limbs, m_limbs.end());
+
+    for (int d = 0; d < digits; d++)
+    {
+      uint64_t carry = 0;
+
+      for (auto it = fraction.rbegin(); it != fraction.rend(); ++it)
+      {
+        const uint64_t t = (uint64_t)*it * 10 + carry;
+        *it = (uint32_t)t;
+        carry = t >> 32;
+      }
+
+      text += (char)('0' + carry);
+    }
+  }
+
+  return text;
+}
+
+BigReal BigReal::operator-() const
+{
+  BigReal r(*this);
+
+  if (!r.isZero())
+  {
+    r.m_negative = !r.m_negative;
+  }
+
+  return r;
+}
+
+BigReal BigReal::operator+(const BigReal& other) const
+{
+  return add(*this, other, false);
+}
+
+BigReal BigReal::operator-(const BigReal& other) const
+{
+  return add(*this, other, true);
+}
+
+BigReal BigReal::operator*(const BigReal& other) const
+{
+  const int limbs = std::max(this->limbs(), other.limbs());
+  const int size = int_limbs + limbs;
+
+  // little endian copies
+  std::vector<uint32_t> a(m_limbs.rbegin(), m_limbs.rend());
+  std::vector<uint32_t> b(other.m_limbs.rbegin(), other.m_limbs.rend());
+  a.insert(a.begin(), size - a.size(), 0);
+  b.insert(b.begin(), size - b.size(), 0);
+
+  std::vector<uint32_t> p(2 * size, 0);
+
+  for (int i = 0; i < size; i++)
+  {
+    if (a[i] == 0)
+    {
+      continue;
+    }
+
+    uint64_t carry = 0;
+
+    for (int j = 0; j < size; j++)
+    {
+      const uint64_t t = (uint64_t)a[i] * b[j] + p[i + j] + carry;
+      p[i + j] = (uint32_t)t;
+      carry = t >> 32;
+    }
+
+    p[i + size] = (uint32_t)carry;
+  }
+
+  // the product has twice the fractional limbs,
+  // keep the limbs at the fixed point, integer overflow is lost
+  BigReal r(0, limbs);
+
+  for (int i = 0; i < size; i++)
+  {
+    r.m_limbs[size - 1 - i] = p[i + limbs];
+  }
+
+  r.m_negative = (m_negative != other.m_negative) && !r.isZero();
+
+  return r;
+}
+
+bool BigReal::operator<(const BigReal& other) const
+{
+  if (m_negative != other.m_negative)
+  {
+    return m_negative;
+  }
+
+  const int c = compare(m_limbs, other.m_limbs);
+
+  return m_negative ? c > 0: c < 0;
+}
+
+bool BigReal::operator==(const BigReal& other) const
+{
+  return
+    m_negative == other.m_negative &&
+    compare(m_limbs, other.m_limbs) == 0;
+}
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      bigreal.h
+// Purpose:   Declaration of class BigReal
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// This class offers an arbitrary precision real number.
+/// It is a fixed point number, with 64 integer bits and a number
+/// of fractional 32 bit limbs, enough for fractal coordinates and orbits.
+class BigReal
+{
+public:
+  /// Default constructor.
+  BigReal(
+    /// the value
+    double value = 0,
+    /// number of fractional limbs
+    int limbs = 2);
+
+  /// Returns a value from a decimal string, like "-0.75000000000000000001".
+  static BigReal fromString(
+    /// the string
+    const std::string& text,
+    /// number of fractional limbs
+    int limbs = 2);
+
+  /// Returns number of fractional limbs needed to resolve
+  /// the resolution, with some guard limbs.
+  static int limbsFor(double resolution);
+
+  /// Gets number of fractional limbs.
+  int limbs() const {return (int)m_limbs.size() - int_limbs;};
+
+  /// Sets number of fractional limbs, the value is truncated or extended.
+  void setLimbs(int limbs);
+
+  /// Returns the nearest double.
+  double toDouble() const;
+
+  /// Returns a decimal string.
+  std::string toString(
+    /// number of fractional digits
+    int digits = 20) const;
+
+  /// Operators.
+  BigReal operator-() const;
+  BigReal operator+(const BigReal& other) const;
+  BigReal operator-(const BigReal& other) const;
+  BigReal operator*(const BigReal& other) const;
+  bool operator<(const BigReal& other) const;
+  bool operator==(const BigReal& other) const;
+  bool operator!=(const BigReal& other) const {return !(*this == other);};
+private:
+  static const int int_limbs = 2;
+
+  static BigReal add(const BigReal& a, const BigReal& b, bool negate);
+  static int compare(
+    const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+  void divide(uint32_t value);
+  bool isZero() const;
+
+  // most significant limb first
+  std::vector<uint32_t> m_limbs;
+  bool m_negative = false;
+};
@@ -0,0 +1,297 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      bigtiff.cpp
+// Purpose:   Implementation of class BigTiff
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <map>
+#include <vector>
+#include <QtEndian>
+#include "bigtiff.h"
+
+// The tags used, see the TIFF 6.0 and BigTIFF specifications.
+enum
+{
+  TAG_WIDTH         = 256,
+  TAG_LENGTH        = 257,
+  TAG_BITS          = 258,
+  TAG_COMPRESSION   = 259,
+  TAG_PHOTOMETRIC   = 262,
+  TAG_DESCRIPTION   = 270,
+  TAG_STRIP_OFFSETS = 273,
+  TAG_SAMPLES       = 277,
+  TAG_ROWS          = 278,
+  TAG_STRIP_COUNTS  = 279,
+  TAG_PLANAR        = 284,
+};
+
+enum
+{
+  TYPE_ASCII = 2,
+  TYPE_SHORT = 3,
+  TYPE_LONG  = 4,
+  TYPE_LONG8 = 16,
+};
+
+const int compression_deflate = 8;
+const int entries = 11;
+const int entry_size = 20;
+const int header_size = 16;
+
+template <typename T>
+static void append(QByteArray& data, T value)
+{
+  value = qToLittleEndian(value);
+  data.append((const char*)&value, sizeof(T));
+}
+
+static int typeSize(int type)
+{
+  switch (type)
+  {
+    case TYPE_ASCII: return 1;
+    case TYPE_SHORT: return 2;
+    case TYPE_LONG: return 4;
+    default: return 8;
+  }
+}
+
+template <typename T>
+static QByteArray values(const std::vector<T>& v)
+{
+  QByteArray data;
+
+  for (const auto & i : v)
+  {
+    append(data, i);
+  }
+
+  return data;
+}
+
+bool BigTiff::create(const QString& description)
+{
+  QByteArray header("II", 2);
+  append(header, (quint16)43);
+  append(header, (quint16)8);
+  append(header, (quint16)0);
+  append(header, (quint64)header_size);
+
+  // The directory follows the header, the values that do not fit
+  // in an entry follow the directory.
+  const qint64 start = header_size + 8 + entries * entry_size + 8;
+  QByteArray dir, data;
+  append(dir, (quint64)entries);
+
+  // Returns the position of the value.
+  const auto entry = [&](
+    quint16 tag, quint16 type, quint64 count, const QByteArray& value) {
+    append(dir, tag);
+    append(dir, type);
+    append(dir, count);
+
+    if (value.size() <= 8)
+    {
+      const qint64 pos = header_size + dir.size();
+      dir.append(value);
+      dir.append(QByteArray(8 - value.size(), '\0'));
+      return pos;
+    }
+
+    const qint64 pos = start + data.size();
+    append(dir, (quint64)pos);
+    data.append(value);
+    return pos;};
+
+  const QByteArray text(description.toLatin1() + '\0');
+  const std::vector<quint64> strips(m_strips, 0);
+
+  entry(TAG_WIDTH, TYPE_LONG, 1, values<quint32>({(quint32)m_size.width()}));
+  entry(TAG_LENGTH, TYPE_LONG, 1, values<quint32>({(quint32)m_size.height()}));
+  entry(TAG_BITS, TYPE_SHORT, 3, values<quint16>({8, 8, 8}));
+  entry(TAG_COMPRESSION, TYPE_SHORT, 1, values<quint16>({compression_deflate}));
+  entry(TAG_PHOTOMETRIC, TYPE_SHORT, 1, values<quint16>({2}));
+  entry(TAG_DESCRIPTION, TYPE_ASCII, text.size(), text);
+  m_offsets = entry(TAG_STRIP_OFFSETS, TYPE_LONG8, m_strips, values(strips));
+  entry(TAG_SAMPLES, TYPE_SHORT, 1, values<quint16>({3}));
+  entry(TAG_ROWS, TYPE_LONG, 1, values<quint32>({(quint32)m_rows}));
+  m_counts = entry(TAG_STRIP_COUNTS, TYPE_LONG8, m_strips, values(strips));
+  entry(TAG_PLANAR, TYPE_SHORT, 1, values<quint16>({1}));
+  append(dir, (quint64)0);
+
+  const QByteArray file(header + dir + data);
+
+  return m_file.write(file) == file.size() && m_file.flush();
+}
+
+bool BigTiff::open(
+  const QString& file, const QSize& size, int rows, const QString& description)
+{
+  m_file.close();
+  m_file.setFileName(file);
+  m_size = size;
+
+  if (m_file.exists() && m_file.open(QIODevice::ReadWrite) && resume(description))
+  {
+    return true;
+  }
+
+  m_file.close();
+
+  m_rows = std::max(1, std::min(rows, size.height()));
+  m_strips = (size.height() + m_rows - 1) / m_rows;
+  m_strip = 0;
+
+  return
+    !size.isEmpty() &&
+    m_file.open(QIODevice::ReadWrite | QIODevice::Truncate) &&
+    create(description);
+}
+
+bool BigTiff::resume(const QString& description)
+{
+  const qint64 size = m_file.size();
+  const uchar* data = (size > header_size ? m_file.map(0, size): nullptr);
+
+  if (data == nullptr)
+  {
+    return false;
+  }
+
+  // Reads a little endian value, 0 outside the file.
+  const auto read = [&](qint64 pos, int bytes) {
+    quint64 value = 0;
+
+    if (pos >= 0 && pos + bytes <= size)
+    {
+      for (int i = bytes - 1; i >= 0; i--)
+      {
+        value = (value << 8) | data[pos + i];
+      }
+    }
+
+    return value;};
+
+  struct Field
+  {
+    quint64 m_count = 0;
+    qint64 m_pos = -1;
+  };
+
+  std::map<int, Field> fields;
+  const qint64 ifd = read(8, 8);
+
+  if (data[0] == 'I' && data[1] == 'I' && read(2, 2) == 43 && read(4, 2) == 8)
+  {
+    for (int i = 0; i < std::min((int)read(ifd, 8), 2 * entries); i++)
+    {
+      const qint64 e = ifd + 8 + i * entry_size;
+      const quint64 count = read(e + 4, 8);
+
+      fields[read(e, 2)] = {count,
+        count * typeSize(read(e + 2, 2)) <= 8 ? e + 12: (qint64)read(e + 12, 8)};
+    }
+  }
+
+  const QByteArray text(description.toLatin1() + '\0');
+  const Field& dscr(fields[TAG_DESCRIPTION]);
+
+  m_rows = read(fields[TAG_ROWS].m_pos, 4);
+  m_strips = fields[TAG_STRIP_OFFSETS].m_count;
+  m_offsets = fields[TAG_STRIP_OFFSETS].m_pos;
+  m_counts = fields[TAG_STRIP_COUNTS].m_pos;
+  m_strip = 0;
+
+  bool ok =
+    read(fields[TAG_WIDTH].m_pos, 4) == (quint64)m_size.width() &&
+    read(fields[TAG_LENGTH].m_pos, 4) == (quint64)m_size.height() &&
+    read(fields[TAG_COMPRESSION].m_pos, 2) == compression_deflate &&
+    dscr.m_count == (quint64)text.size() &&
+    dscr.m_pos >= 0 && dscr.m_pos + text.size() <= size &&
+    memcmp(data + dscr.m_pos, text.constData(), text.size()) == 0 &&
+    m_rows > 0 &&
+    m_strips == (m_size.height() + m_rows - 1) / m_rows &&
+    fields[TAG_STRIP_COUNTS].m_count == (quint64)m_strips &&
+    m_offsets > 0 && m_offsets + 8 * m_strips <= size &&
+    m_counts > 0 && m_counts + 8 * m_strips <= size;
+
+  qint64 end = 0;
+
+  if (ok)
+  {
+    while (m_strip < m_strips && read(m_counts + 8 * m_strip, 8) > 0)
+    {
+      m_strip++;
+    }
+
+    // A file without strips is created again.
+    if (m_strip > 0)
+    {
+      end =
+        read(m_offsets + 8 * (m_strip - 1), 8) +
+        read(m_counts + 8 * (m_strip - 1), 8);
+    }
+
+    ok = (end > 0 && end <= size);
+  }
+
+  m_file.unmap((uchar*)data);
+
+  // A strip that was written without its byte count is dropped.
+  return ok && (end == size || m_file.resize(end));
+}
+
+bool BigTiff::write(const QImage& image)
+{
+  if (isFinished() ||
+    image.width() != m_size.width() || image.height() != rowsToWrite())
+  {
+    return false;
+  }
+
+  QByteArray rgb(image.width() * image.height() * 3, Qt::Uninitialized);
+  char* p = rgb.data();
+
+  for (int y = 0; y < image.height(); y++)
+  {
+    const QRgb* line = (const QRgb*)image.constScanLine(y);
+
+    for (int x = 0; x < image.width(); x++)
+    {
+      *p++ = qRed(line[x]);
+      *p++ = qGreen(line[x]);
+      *p++ = qBlue(line[x]);
+    }
+  }
+
+  // qCompress prepends the uncompressed size to a zlib stream.
+  const QByteArray strip(qCompress(rgb).mid(4));
+  const qint64 offset = m_file.size();
+
+  if (!m_file.seek(offset) ||
+    m_file.write(strip) != strip.size() ||
+    !m_file.flush())
+  {
+    return false;
+  }
+
+  // The byte count is written last, it marks the strip as written.
+  QByteArray value;
+  append(value, (quint64)offset);
+  append(value, (quint64)strip.size());
+
+  if (!m_file.seek(m_offsets + 8 * m_strip) ||
+    m_file.write(value.left(8)) != 8 ||
+    !m_file.seek(m_counts + 8 * m_strip) ||
+    m_file.write(value.mid(8)) != 8 ||
+    !m_file.flush())
+  {
+    return false;
+  }
+
+  m_strip++;
+
+  return true;
+}
@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      bigtiff.h
+// Purpose:   Declaration of class BigTiff
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <algorithm>
+#include <QFile>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+/// This class writes an RGB image into a BigTIFF file, strip by strip,
+/// so an image far larger than memory can be written.
+/// The strips are deflate compressed. The directory is written in front
+/// of the strips, and the offset and byte count of each strip are
+/// filled in after the strip is written, so a partial file is resumed
+/// at the first strip without byte count (see open).
+class BigTiff
+{
+public:
+  /// Returns true if all strips are written.
+  bool isFinished() const {return m_strip == m_strips;};
+
+  /// Opens file for an image.
+  /// If the file is a partial image of the same size and description,
+  /// it is resumed, keeping its rows per strip, otherwise it is created.
+  /// Returns false if the file could not be opened.
+  bool open(
+    /// the file
+    const QString& file,
+    /// size of the image
+    const QSize& size,
+    /// rows per strip
+    int rows,
+    /// description, e.g. the parameters of the image
+    const QString& description);
+
+  /// Returns rows per strip.
+  auto rows() const {return m_rows;};
+
+  /// Returns rows of the next strip to write.
+  int rowsToWrite() const {
+    return std::min(m_rows, m_size.height() - m_strip * m_rows);};
+
+  /// Returns size of the image.
+  const auto & size() const {return m_size;};
+
+  /// Returns index of the next strip to write.
+  auto strip() const {return m_strip;};
+
+  /// Returns number of strips.
+  auto strips() const {return m_strips;};
+
+  /// Writes the next strip, the image has the width of the image
+  /// and rowsToWrite rows.
+  /// Returns false if the strip could not be written.
+  bool write(const QImage& image);
+private:
+  bool create(const QString& description);
+  bool resume(const QString& description);
+
+  QFile m_file;
+  QSize m_size;
+  int m_rows = 0;
+  int m_strip = 0;
+  int m_strips = 0;
+
+  // positions of the strip offsets and byte counts in the directory
+  qint64 m_offsets = 0;
+  qint64 m_counts = 0;
+};
@@ -0,0 +1,27 @@
+################################################################################
+# Name:      core.pri
+# Purpose:   Qt project include file to link with the core library
+# Author:    Anton van Wezenbeek
+# Copyright: (c) 2026 Anton van Wezenbeek
+################################################################################
+
+QT += core gui
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+CORE_OUT = $$shadowed($$PWD)
+
+win32 {
+  CONFIG(debug, debug|release): CORE_OUT = $$CORE_OUT/debug
+  else: CORE_OUT = $$CORE_OUT/release
+}
+
+LIBS += -L$$CORE_OUT -lfractalcore
+
+win32-msvc* {
+  PRE_TARGETDEPS += $$CORE_OUT/fractalcore.lib
+}
+else {
+  PRE_TARGETDEPS += $$CORE_OUT/libfractalcore.a
+}
@@ -0,0 +1,43 @@
+################################################################################
+# Name:      core.pro
+# Purpose:   Qt project file of the core library
+# Author:    Anton van Wezenbeek
+# Copyright: (c) 2026 Anton van Wezenbeek
+################################################################################
+
+TEMPLATE = lib
+TARGET = fractalcore
+CONFIG += staticlib
+QT = core gui
+
+# The SIMD kernels must give the same results as the scalar kernels,
+# and double-double needs exact rounding, so do not fuse multiply and add.
+*g++*|*clang* {
+  QMAKE_CXXFLAGS += -ffp-contract=off
+}
+
+HEADERS += \
+  bigreal.h \
+  bigtiff.h \
+  doubledouble.h \
+  fractal.h \
+  fractalcache.h \
+  fractalframe.h \
+  fractalgeometry.h \
+  fractalinterval.h \
+  fractalrenderer.h \
+  fractalsimd.h \
+  perturbation.h \
+  renderpool.h
+
+SOURCES += \
+  bigreal.cpp \
+  bigtiff.cpp \
+  fractal.cpp \
+  fractalcache.cpp \
+  fractalframe.cpp \
+  fractalgeometry.cpp \
+  fractalrenderer.cpp \
+  fractalsimd.cpp \
+  perturbation.cpp \
+  renderpool.cpp
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      doubledouble.h
+// Purpose:   Declaration of class DoubleDouble
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/// This class offers a double-double real number, the unevaluated
+/// sum of two doubles, giving about 106 bits of precision.
+/// It is much faster than BigReal, and is used for views that
+/// are too deep for double precision.
+/// The error free transformations need exact rounding of each operation,
+/// so multiply and add must not be fused (see -ffp-contract in core.pro).
+class DoubleDouble
+{
+public:
+  /// Relative precision.
+  static constexpr double epsilon = 4.93038065763132e-32; // 2^-104
+
+  /// Default constructor.
+  DoubleDouble(double value = 0)
+    : m_hi(value) {;};
+
+  /// Constructor from a sum, the parts are normalized.
+  DoubleDouble(double hi, double lo) {
+    m_hi = twoSum(hi, lo, m_lo);};
+
+  /// Gets the high part.
+  auto hi() const {return m_hi;};
+
+  /// Gets the low part.
+  auto lo() const {return m_lo;};
+
+  /// Returns the nearest double.
+  double toDouble() const {return m_hi + m_lo;};
+
+  /// Operators.
+  DoubleDouble operator-() const {
+    DoubleDouble r; r.m_hi = -m_hi; r.m_lo = -m_lo; return r;};
+
+  DoubleDouble operator+(const DoubleDouble& other) const {
+    double e;
+    const double s = twoSum(m_hi, other.m_hi, e);
+    return DoubleDouble(s, e + m_lo + other.m_lo);};
+
+  DoubleDouble operator-(const DoubleDouble& other) const {
+    return *this + -other;};
+
+  DoubleDouble operator*(const DoubleDouble& other) const {
+    double e;
+    const double p = twoProd(m_hi, other.m_hi, e);
+    return DoubleDouble(p, e + m_hi * other.m_lo + m_lo * other.m_hi);};
+
+  DoubleDouble& operator+=(const DoubleDouble& other) {
+    return *this = *this + other;};
+
+  bool operator>(double value) const {
+    return m_hi > value || (m_hi == value && m_lo > 0);};
+private:
+  // Dekker split of a double into two halves of 26 bits.
+  static void split(double a, double& hi, double& lo) {
+    const double t = 134217729.0 * a; // 2^27 + 1
+    hi = t - (t - a);
+    lo = a - hi;};
+
+  // a * b = p + e exactly
+  static double twoProd(double a, double b, double& e) {
+    const double p = a * b;
+    double ah, al, bh, bl;
+    split(a, ah, al);
+    split(b, bh, bl);
+    e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    return p;};
+
+  // a + b = s + e exactly
+  static double twoSum(double a, double b, double& e) {
+    const double s = a + b;
+    const double v = s - a;
+    e = (a - (s - v)) + (b - v);
+    return s;};
+
+  double m_hi;
+  double m_lo = 0;
+};
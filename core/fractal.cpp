@@ -0,0 +1,742 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      fractal.cpp
+// Purpose:   Implementation of class Fractal
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2017-2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <limits>
+#include "fractal.h"
+#include "doubledouble.h"
+#include "fractalrenderer.h"
+#include "fractalsimd.h"
+
+enum
+{
+  FRACTAL_MANDELBROTSET = 0,
+  FRACTAL_JULIASET,
+  FRACTAL_JULIASET_1,
+  FRACTAL_JULIASET_2,
+  FRACTAL_JULIASET_3,
+  FRACTAL_JULIASET_4,
+  FRACTAL_JULIASET_5,
+  FRACTAL_JULIASET_6,
+  FRACTAL_JULIASET_7,
+  FRACTAL_JULIASET_8,
+  FRACTAL_JULIASET_9,
+  FRACTAL_GLYNN,
+};
+
+// Number of iterations between checks for interruption.
+const int check_iterations = 256;
+
+// Headroom of the precision for errors growing during iterations.
+const double precision_headroom = 1024;
+
+// Squared distance of a close return of an orbit to its checkpoint.
+const double cycle_tolerance = 1e-20;
+
+// Powers used by the kernels, specialized at compile time.
+// Each one calculates z = z^exp in place.
+
+// z^1.5 = z * sqrt(z), used by the glynn fractal
+struct PowerGlynn
+{
+  static void apply(double& x, double& y, double)
+  {
+    const std::complex<double> z(x, y);
+    const std::complex<double> r(z * std::sqrt(z));
+    x = r.real();
+    y = r.imag();
+  }
+
+  static std::complex<double> derivative(
+    const std::complex<double>& z, double)
+  {
+    return 1.5 * std::sqrt(z);
+  }
+};
+
+// z^N for an integer exponent
+template <int N>
+struct PowerInt
+{
+  template <typename T>
+  static void apply(T& x, T& y, double)
+  {
+    const T zr = x;
+    const T zi = y;
+
+    for (int i = 1; i < N; i++)
+    {
+      const T xt = x * zr - y * zi;
+      y = x * zi + y * zr;
+      x = xt;
+    }
+  }
+
+  static std::complex<double> derivative(
+    const std::complex<double>& z, double)
+  {
+    return (double)N * std::pow(z, N - 1);
+  }
+};
+
+// z^exp for any exponent
+struct PowerReal
+{
+  static void apply(double& x, double& y, double exp)
+  {
+    const std::complex<double> r(std::pow(std::complex<double>(x, y), exp));
+    x = r.real();
+    y = r.imag();
+  }
+
+  static std::complex<double> derivative(
+    const std::complex<double>& z, double exp)
+  {
+    return exp * std::pow(z, exp - 1);
+  }
+};
+
+// Returns true if the orbit of z = z^exp + k returns to z after period
+// iterations with a multiplier below 1, see FractalSimd::attracting.
+template <typename Power>
+static bool attracting(
+  double x, double y, double kr, double ki, double exp, int period)
+{
+  std::complex<double> d(1);
+
+  for (int i = 0; i < period; i++)
+  {
+    d *= Power::derivative(std::complex<double>(x, y), exp);
+    Power::apply(x, y, exp);
+    x += kr;
+    y += ki;
+
+    if (std::norm(d) > 1e200)
+    {
+      return false;
+    }
+  }
+
+  return std::norm(d) < 1;
+}
+
+// Returns true if c is in the main cardioid or in the period 2 bulb
+// of the mandelbrot set z = z^2 + c, and counts it.
+static bool bounded(double cr, double ci, int& cardioid, int& bulb)
+{
+  const double xq = cr - 0.25;
+  const double q = xq * xq + ci * ci;
+
+  if (q * (q + xq) <= 0.25 * ci * ci)
+  {
+    cardioid++;
+    return true;
+  }
+
+  if ((cr + 1) * (cr + 1) + ci * ci <= 0.0625)
+  {
+    bulb++;
+    return true;
+  }
+
+  return false;
+}
+
+// Returns the center plus a distance, each rounded once to the scalar
+// type, as FractalRenderer::calcPoints does.
+template <typename T>
+static T coordinate(const DoubleDouble& center, double delta)
+{
+  return T(center.hi()) + T(delta);
+}
+
+template <>
+DoubleDouble coordinate<DoubleDouble>(const DoubleDouble& center, double delta)
+{
+  return center + DoubleDouble(delta);
+}
+
+static double toDouble(double value) {return value;}
+static double toDouble(const DoubleDouble& value) {return value.toDouble();}
+
+std::vector<std::string> Fractal::m_names;
+
+Fractal::Fractal(
+  const std::string& name,
+  double diverge,
+  const std::complex<double> & c,
+  double exp)
+  : m_diverge(diverge)
+  , m_julia(c)
+  , m_juliaExponent(exp)
+{
+  setName(name);
+}
+
+bool Fractal::calc(
+  const std::complex<double> & c, 
+  int& n, 
+  int max) const
+{ 
+  return calc(&c, &n, 1, max);
+}
+
+bool Fractal::calc(
+  const std::complex<double>* c,
+  int* n,
+  int count,
+  int max) const
+{
+  if (m_kernel == nullptr)
+  {
+    return false;
+  }
+  
+  std::vector<double> x(count), y(count);
+  
+  for (int i = 0; i < count; i++)
+  {
+    x[i] = c[i].real();
+    y[i] = c[i].imag();
+  }
+  
+  return m_kernel(*this, x.data(), y.data(), n, count, max, nullptr);
+}
+
+bool Fractal::calc(const FractalTile& tile, int* n) const
+{
+  const auto run = [&](auto kernel, auto scalar) {
+    typedef decltype(scalar) T;
+    
+    if (kernel == nullptr)
+    {
+      return false;
+    }
+    
+    const int count = tile.m_deltaX.size() * tile.m_deltaY.size();
+    std::vector<T> x(count), y(count);
+    int i = 0;
+    
+    for (const auto dy : tile.m_deltaY)
+    {
+      const T cy(coordinate<T>(tile.m_centerY, dy));
+      
+      for (const auto dx : tile.m_deltaX)
+      {
+        x[i] = coordinate<T>(tile.m_centerX, dx);
+        y[i++] = cy;
+      }
+    }
+    
+    return count == 0 || 
+      kernel(*this, x.data(), y.data(), n, count, tile.m_depth, nullptr);};
+  
+  switch (tile.m_precision)
+  {
+    case PRECISION_FLOAT: return run(m_kernelFloat, float());
+    case PRECISION_DOUBLE: return run(m_kernel, double());
+    case PRECISION_DOUBLE_DOUBLE:
+      return run(m_kernelDoubleDouble, DoubleDouble());
+    default: return false;
+  }
+}
+
+bool Fractal::interrupted() const
+{
+  return m_renderer != nullptr && m_renderer->interrupted();
+}
+
+bool Fractal::isMandelbrot() const
+{
+  return m_type == FRACTAL_MANDELBROTSET;
+}
+
+bool Fractal::isOk() const
+{
+  return !m_name.empty();
+}
+
+bool Fractal::isQuadratic() const
+{
+  return 
+    m_kernel == &mandelbrotset<double> || 
+    m_kernel == &juliasetQuadratic<double>;
+}
+
+template <typename T, typename Power>
+bool Fractal::juliaset(
+  const Fractal& fractal,
+  const T* x0, 
+  const T* y0, 
+  int* n,
+  int count,
+  int max,
+  FractalOrbits<T>* orbits)
+{
+  const double diverge2 = fractal.m_diverge * fractal.m_diverge;
+  const double exp = fractal.m_juliaExponent;
+  const int start = (orbits != nullptr ? orbits->m_start: 0);
+  const T kr(fractal.m_julia.real());
+  const T ki(fractal.m_julia.imag());
+  
+  int cycles = 0;
+
+  for (int i = 0; i < count; i++)
+  {
+    T x = (start > 0 ? orbits->m_zr[i]: x0[i]);
+    T y = (start > 0 ? orbits->m_zi[i]: y0[i]);
+    T sx = x;
+    T sy = y;
+    int saved = start;
+    
+    for (n[i] = start; n[i] < max; n[i]++)
+    {
+      Power::apply(x, y, exp);
+      x += kr;
+      y += ki;
+        
+      if (x * x + y * y > diverge2)
+      {
+        break;
+      }
+      
+      // Brent's cycle detection, as in FractalSimd
+      const int j = n[i];
+      
+      if ((j & 3) == 3)
+      {
+        const double dx = toDouble(x - sx);
+        const double dy = toDouble(y - sy);
+        
+        if (dx * dx + dy * dy < cycle_tolerance && attracting<Power>(
+          toDouble(x), toDouble(y), toDouble(kr), toDouble(ki), 
+          exp, j + 1 - saved))
+        {
+          n[i] = max;
+          cycles++;
+          break;
+        }
+        
+        if (((j + 1) & j) == 0)
+        {
+          sx = x;
+          sy = y;
+          saved = j + 1;
+        }
+      }
+    
+      if ((j % check_iterations) == check_iterations - 1 &&
+        fractal.interrupted())
+      {
+        return false;
+      }
+    }
+    
+    if (orbits != nullptr)
+    {
+      orbits->m_zr[i] = x;
+      orbits->m_zi[i] = y;
+    }
+  }
+  
+  fractal.m_stats.add(FractalStats::SHORTCUT_CYCLE, cycles);
+  
+  return !fractal.interrupted();
+}
+
+template <typename T>
+bool Fractal::juliasetQuadratic(
+  const Fractal& fractal,
+  const T* x, 
+  const T* y, 
+  int* n,
+  int count,
+  int max,
+  FractalOrbits<T>* orbits)
+{
+  return quadratic(fractal, x, y, n, count, max, orbits, false);
+}
+
+template <typename T>
+bool Fractal::mandelbrotset(
+  const Fractal& fractal,
+  const T* x, 
+  const T* y, 
+  int* n,
+  int count,
+  int max,
+  FractalOrbits<T>* orbits)
+{
+  return quadratic(fractal, x, y, n, count, max, orbits, true);
+}
+
+template <typename T>
+bool Fractal::quadratic(
+  const Fractal& fractal,
+  const T* x, 
+  const T* y, 
+  int* n,
+  int count,
+  int max,
+  FractalOrbits<T>* orbits,
+  bool mandelbrot)
+{
+  // Float and double use the SIMD kernels, with start and added values,
+  // the mandelbrot set z = z^2 - c starts at 0, a julia set
+  // z = z^2 + julia starts at c, or at the orbits to continue.
+  // Points in the cardioid or bulb are not passed to the SIMD kernels.
+  const int chunk = 64;
+  T zr[chunk], zi[chunk], kr[chunk], ki[chunk];
+  int index[chunk], m[chunk];
+  int size = 0, cardioid = 0, bulb = 0, cycles = 0;
+
+  const int start = (orbits != nullptr ? orbits->m_start: 0);
+  const auto interrupted = [&fractal]() {return fractal.interrupted();};
+  const auto escape = [&]() {
+    if (!FractalSimd::escape(zr, zi, kr, ki, size, 
+      (T)(fractal.m_diverge * fractal.m_diverge), max - start, m, &cycles, 
+      interrupted))
+    {
+      return false;
+    }
+    
+    for (int j = 0; j < size; j++)
+    {
+      n[index[j]] = start + m[j];
+      
+      if (orbits != nullptr)
+      {
+        orbits->m_zr[index[j]] = zr[j];
+        orbits->m_zi[index[j]] = zi[j];
+      }
+    }
+    
+    size = 0;
+    
+    return true;};
+
+  for (int i = 0; i < count; i++)
+  {
+    if (mandelbrot && bounded(-x[i], -y[i], cardioid, bulb))
+    {
+      n[i] = max;
+      continue;
+    }
+    
+    index[size] = i;
+    zr[size] = start > 0 ? orbits->m_zr[i]: mandelbrot ? 0: x[i];
+    zi[size] = start > 0 ? orbits->m_zi[i]: mandelbrot ? 0: y[i];
+    kr[size] = mandelbrot ? -x[i]: (T)fractal.m_julia.real();
+    ki[size] = mandelbrot ? -y[i]: (T)fractal.m_julia.imag();
+    
+    if (++size == chunk && !escape())
+    {
+      return false;
+    }
+  }
+
+  if (size > 0 && !escape())
+  {
+    return false;
+  }
+  
+  fractal.m_stats.add(FractalStats::SHORTCUT_CARDIOID, cardioid);
+  fractal.m_stats.add(FractalStats::SHORTCUT_BULB, bulb);
+  fractal.m_stats.add(FractalStats::SHORTCUT_CYCLE, cycles);
+
+  return !fractal.interrupted();
+}
+
+template <>
+bool Fractal::quadratic<DoubleDouble>(
+  const Fractal& fractal,
+  const DoubleDouble* x, 
+  const DoubleDouble* y, 
+  int* n,
+  int count,
+  int max,
+  FractalOrbits<DoubleDouble>* orbits,
+  bool mandelbrot)
+{
+  // Double-double has no SIMD kernel, same iteration 
+  // and cycle detection as the SIMD kernels.
+  const double diverge2 = fractal.m_diverge * fractal.m_diverge;
+  const int start = (orbits != nullptr ? orbits->m_start: 0);
+  
+  int cardioid = 0, bulb = 0, cycles = 0;
+
+  for (int i = 0; i < count; i++)
+  {
+    if (mandelbrot && 
+      bounded(-x[i].toDouble(), -y[i].toDouble(), cardioid, bulb))
+    {
+      n[i] = max;
+      continue;
+    }
+    
+    const DoubleDouble kr(mandelbrot ? -x[i]: fractal.m_julia.real());
+    const DoubleDouble ki(mandelbrot ? -y[i]: fractal.m_julia.imag());
+    DoubleDouble zr(start > 0 ? orbits->m_zr[i]: mandelbrot ? 0: x[i]);
+    DoubleDouble zi(start > 0 ? orbits->m_zi[i]: mandelbrot ? 0: y[i]);
+    DoubleDouble sr(zr);
+    DoubleDouble si(zi);
+    int saved = start;
+
+    for (n[i] = start; n[i] < max; n[i]++)
+    {
+      const DoubleDouble xy(zr * zi);
+      zr = zr * zr - zi * zi + kr;
+      zi = xy + xy + ki;
+
+      if (zr * zr + zi * zi > diverge2)
+      {
+        break;
+      }
+      
+      const int j = n[i];
+      
+      if ((j & 3) == 3)
+      {
+        const double dx = (zr - sr).toDouble();
+        const double dy = (zi - si).toDouble();
+        
+        if (dx * dx + dy * dy < cycle_tolerance && FractalSimd::attracting(
+          zr.toDouble(), zi.toDouble(), kr.toDouble(), ki.toDouble(), 
+          j + 1 - saved))
+        {
+          n[i] = max;
+          cycles++;
+          break;
+        }
+        
+        if (((j + 1) & j) == 0)
+        {
+          sr = zr;
+          si = zi;
+          saved = j + 1;
+        }
+      }
+
+      if ((j % check_iterations) == check_iterations - 1 &&
+        fractal.interrupted())
+      {
+        return false;
+      }
+    }
+    
+    if (orbits != nullptr)
+    {
+      orbits->m_zr[i] = zr;
+      orbits->m_zi[i] = zi;
+    }
+  }
+  
+  fractal.m_stats.add(FractalStats::SHORTCUT_CARDIOID, cardioid);
+  fractal.m_stats.add(FractalStats::SHORTCUT_BULB, bulb);
+  fractal.m_stats.add(FractalStats::SHORTCUT_CYCLE, cycles);
+
+  return !fractal.interrupted();
+}
+
+std::vector<std::string> & Fractal::names()
+{
+  if (m_names.empty())
+  {
+    m_names.push_back("mandelbrot set");
+    m_names.push_back("julia set");
+    m_names.push_back("julia set 1");
+    m_names.push_back("julia set 2");
+    m_names.push_back("julia set 3");
+    m_names.push_back("julia set 4");
+    m_names.push_back("julia set 5");
+    m_names.push_back("julia set 6");
+    m_names.push_back("julia set 7");
+    m_names.push_back("julia set 8");
+    m_names.push_back("julia set 9");
+    m_names.push_back("glynn");
+  }
+
+  return m_names;  
+}
+
+FractalPrecision Fractal::precision(double magnitude, double spacing) const
+{
+  const auto resolves = [&](double epsilon) {
+    return spacing >= magnitude * epsilon * precision_headroom;};
+    
+  if (m_kernelFloat != nullptr && 
+    resolves(std::numeric_limits<float>::epsilon()))
+  {
+    return PRECISION_FLOAT;
+  }
+  
+  if (resolves(std::numeric_limits<double>::epsilon()) ||
+    (m_kernelDoubleDouble == nullptr && !isQuadratic()))
+  {
+    return PRECISION_DOUBLE;
+  }
+  
+  if (m_kernelDoubleDouble != nullptr && 
+    (resolves(DoubleDouble::epsilon) || !isQuadratic()))
+  {
+    return PRECISION_DOUBLE_DOUBLE;
+  }
+  
+  return PRECISION_PERTURBATION;
+}
+
+const char* Fractal::precisionName(FractalPrecision precision)
+{
+  switch (precision)
+  {
+    case PRECISION_FLOAT: return "float";
+    case PRECISION_DOUBLE: return "double";
+    case PRECISION_DOUBLE_DOUBLE: return "double-double";
+    default: return "perturbation";
+  }
+}
+
+bool Fractal::setName(const std::string& name)
+{
+  int type = FRACTAL_MANDELBROTSET;
+  
+  bool isOk = false;
+  
+  for (unsigned int i = 0; i < names().size() && !isOk; i++)
+  {
+    if (m_names[i] == name)
+    {
+      type = i;
+      isOk = true;
+    }
+  }
+  
+  if (!isOk)
+  {
+    return false;
+  }
+  
+  m_name = name;
+  m_type = type;
+  
+  switch (type)
+  {
+    case FRACTAL_JULIASET_1:
+    {
+      const double phi = 1.6180339887498948482;
+      m_julia = std::complex<double>(1 - phi, 0);
+    }
+    break;
+    
+    case FRACTAL_JULIASET_2:
+      m_julia = std::complex<double>(-0.4, 0.6);
+    break;
+    
+    case FRACTAL_JULIASET_3:
+      m_julia = std::complex<double>(0.285, 0);
+    break;
+    
+    case FRACTAL_JULIASET_4:
+      m_julia = std::complex<double>(0.285, 0.01);
+    break;
+    
+    case FRACTAL_JULIASET_5:
+      m_julia = std::complex<double>(0.45, 0.1428);
+    break;
+    
+    case FRACTAL_JULIASET_6:
+      m_julia = std::complex<double>(-0.70176, -0.3842);
+    break;
+    
+    case FRACTAL_JULIASET_7:
+      m_julia = std::complex<double>(-0.835, -0.2321);
+    break;
+    
+    case FRACTAL_JULIASET_8:
+      m_julia = std::complex<double>(-0.8, 0.156);
+    break;
+    
+    case FRACTAL_JULIASET_9:
+      m_julia = std::complex<double>(0, 1);
+    break;
+    
+    case FRACTAL_GLYNN:
+      m_julia = std::complex<double>(-0.2, 0);
+    break;
+  }
+  
+  setKernel();
+  
+  return true;
+}
+
+void Fractal::setJuliaExponent(double exp)
+{
+  m_juliaExponent = exp;
+  setKernel();
+}
+
+void Fractal::setKernel()
+{
+  // The kernel registry, julia set uses the julia exponent.
+  // Kernels with a complex power only exist in double precision,
+  // float kernels only for SIMD.
+  switch (m_type)
+  {
+    case FRACTAL_MANDELBROTSET:
+      setKernels(
+        &mandelbrotset<float>, 
+        &mandelbrotset<double>, 
+        &mandelbrotset<DoubleDouble>);
+      break;
+
+    case FRACTAL_GLYNN:
+      setKernels(nullptr, &juliaset<double, PowerGlynn>, nullptr);
+      break;
+
+    case FRACTAL_JULIASET:
+      if (m_juliaExponent == 2) setKernels(
+        &juliasetQuadratic<float>, 
+        &juliasetQuadratic<double>, 
+        &juliasetQuadratic<DoubleDouble>);
+      else if (m_juliaExponent == 3) setKernels(nullptr, 
+        &juliaset<double, PowerInt<3>>, &juliaset<DoubleDouble, PowerInt<3>>);
+      else if (m_juliaExponent == 4) setKernels(nullptr, 
+        &juliaset<double, PowerInt<4>>, &juliaset<DoubleDouble, PowerInt<4>>);
+      else if (m_juliaExponent == 5) setKernels(nullptr, 
+        &juliaset<double, PowerInt<5>>, &juliaset<DoubleDouble, PowerInt<5>>);
+      else if (m_juliaExponent == 6) setKernels(nullptr, 
+        &juliaset<double, PowerInt<6>>, &juliaset<DoubleDouble, PowerInt<6>>);
+      else if (m_juliaExponent == 7) setKernels(nullptr, 
+        &juliaset<double, PowerInt<7>>, &juliaset<DoubleDouble, PowerInt<7>>);
+      else if (m_juliaExponent == 8) setKernels(nullptr, 
+        &juliaset<double, PowerInt<8>>, &juliaset<DoubleDouble, PowerInt<8>>);
+      else setKernels(nullptr, &juliaset<double, PowerReal>, nullptr);
+      break;
+
+    case -1:
+      setKernels(nullptr, nullptr, nullptr);
+      break;
+
+    default:
+      setKernels(
+        &juliasetQuadratic<float>, 
+        &juliasetQuadratic<double>, 
+        &juliasetQuadratic<DoubleDouble>);
+      break;
+  }
+}
+
+void Fractal::setKernels(
+  FractalKernel<float> kernelFloat,
+  FractalKernel<double> kernel,
+  FractalKernel<DoubleDouble> kernelDoubleDouble)
+{
+  m_kernel = kernel;
+  m_kernelDoubleDouble = kernelDoubleDouble;
+  m_kernelFloat = kernelFloat;
+}
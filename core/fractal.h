@@ -0,0 +1,317 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      fractal.h
+// Purpose:   Declaration of class Fractal
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2017-2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <complex>
+#include <string>
+#include <vector>
+#include "doubledouble.h"
+
+class Fractal;
+class FractalRenderer;
+
+/// The orbits of a number of points, so a kernel can continue
+/// the calculation of points that did not diverge at a higher max.
+template <typename T>
+struct FractalOrbits
+{
+  /// real values of z, receive the values after max iterations
+  /// for points that did not diverge
+  T* m_zr;
+  
+  /// imag values of z, as real values
+  T* m_zi;
+  
+  /// number of iterations done for the values of z,
+  /// 0 starts at the start values
+  int m_start;
+};
+
+/// A kernel calculates a number of points of a fractal, see Fractal::kernel.
+/// It is templated on the scalar type of the coordinates.
+/// Returns true if calculation was not interrupted by renderer.
+template <typename T>
+using FractalKernel = bool (*)(
+  /// the fractal
+  const Fractal& fractal,
+  /// real start values
+  const T* x,
+  /// imag start values
+  const T* y,
+  /// receives number of iterations before diverge for each value
+  int* n,
+  /// number of values
+  int count,
+  /// max iterations
+  int max,
+  /// if not nullptr, the orbits to continue and receive
+  FractalOrbits<T>* orbits);
+
+/// The precisions used for calculation, from cheapest to most precise.
+enum FractalPrecision
+{
+  PRECISION_FLOAT,         /// float, SIMD with twice the lanes of double
+  PRECISION_DOUBLE,        /// double
+  PRECISION_DOUBLE_DOUBLE, /// double-double, see DoubleDouble
+  PRECISION_PERTURBATION,  /// double deltas from a BigReal reference
+};
+
+/// This class counts the points resolved by interior shortcuts,
+/// instead of iterating up to max iterations, and the points guessed
+/// by the renderer.
+/// The kernels add to it concurrently.
+class FractalStats
+{
+public:
+  /// The shortcuts.
+  enum Shortcut
+  {
+    SHORTCUT_CARDIOID, /// in main cardioid of the mandelbrot set
+    SHORTCUT_BULB,     /// in period 2 bulb of the mandelbrot set
+    SHORTCUT_CYCLE,    /// orbit at an attracting cycle
+    SHORTCUT_GUESS,    /// inside a solid area, see FractalGeometry::guess
+    SHORTCUT_MAX,      /// number of shortcuts
+  };
+  
+  /// Default constructor.
+  FractalStats() {reset();};
+  
+  /// Copy constructor.
+  FractalStats(const FractalStats& other) {*this = other;};
+  
+  /// Assignment operator.
+  FractalStats& operator=(const FractalStats& other) {
+    for (int i = 0; i < SHORTCUT_MAX; i++) m_counts[i] = other.m_counts[i].load();
+    return *this;};
+  
+  /// Adds a number of points resolved by a shortcut.
+  void add(Shortcut shortcut, long count) {m_counts[shortcut] += count;};
+
+  /// Adds the counts of other stats.
+  void add(const FractalStats& other) {
+    for (int i = 0; i < SHORTCUT_MAX; i++) m_counts[i] += other.m_counts[i];};
+  
+  /// Returns number of points resolved by a shortcut.
+  long count(Shortcut shortcut) const {return m_counts[shortcut];};
+  
+  /// Resets all counts.
+  void reset() {
+    for (auto& count : m_counts) count = 0;};
+private:
+  std::atomic<long> m_counts[SHORTCUT_MAX];
+};
+
+/// A tile of points on a grid, for calculating the points at once,
+/// see Fractal::calc.
+/// Each point is the center plus the distances of its column and row,
+/// each rounded once to the scalar type of the precision, as the 
+/// renderer does for single points, so both give the same counts.
+struct FractalTile
+{
+  /// real part of the center of the view, a double-double
+  /// so a tile that needs double-double precision is placed exactly
+  DoubleDouble m_centerX;
+  
+  /// imag part of the center of the view
+  DoubleDouble m_centerY;
+  
+  /// real distance from the center for each column
+  std::vector<double> m_deltaX;
+  
+  /// imag distance from the center for each row
+  std::vector<double> m_deltaY;
+  
+  /// the precision to calculate with, e.g. the one the renderer
+  /// resolved for its frame, see Fractal::precision
+  FractalPrecision m_precision;
+  
+  /// max iterations
+  int m_depth;
+};
+
+/// This class offers fractal calculations.
+class Fractal
+{
+public:
+  /// Default constructor.
+  Fractal(
+    /// the name of the fractal, see names
+    const std::string& name = std::string(),
+    /// diverge limit
+    double diverge = 2,
+    /// complex arg (for julia set)
+    const std::complex<double> & c = std::complex<double>(0, 0),
+    /// exponent (for julia set)
+    double exp = 2);
+    
+  /// Do fractal calculation. 
+  /// Returns true if calculation was not interrupted by renderer.
+  bool calc(
+    /// complex start value
+    const std::complex<double> & c,
+    /// number of iterations before diverge
+    int& n, 
+    /// max iterations
+    int max) const;
+    
+  /// Do fractal calculation for a number of points, using the kernel.
+  /// Returns true if calculation was not interrupted by renderer.
+  bool calc(
+    /// complex start values
+    const std::complex<double>* c,
+    /// receives number of iterations before diverge for each value
+    int* n, 
+    /// number of values
+    int count,
+    /// max iterations
+    int max) const;
+    
+  /// Do fractal calculation for a tile of points, calling the kernel
+  /// of the precision of the tile once for all points.
+  /// Returns true if calculation was not interrupted by renderer,
+  /// and false if the fractal has no kernel for the precision,
+  /// e.g. perturbation, the tile is not calculated then.
+  bool calc(
+    /// the tile
+    const FractalTile& tile,
+    /// receives number of iterations before diverge for each point,
+    /// row after row, one value for each column and row
+    int* n) const;
+    
+  /// Gets diverge.
+  auto diverge() const {return m_diverge;};
+    
+  /// Gets julia.
+  const auto & julia() const {return m_julia;};
+    
+  /// Gets julia exponent.
+  auto juliaExponent() const {return m_juliaExponent;};
+    
+  /// Returns true if this is the mandelbrot set.
+  bool isMandelbrot() const;
+    
+  /// Is this fractal ok?
+  bool isOk() const;
+  
+  /// Returns true if this fractal iterates z = z^2 + k,
+  /// the mandelbrot set or a quadratic julia set.
+  bool isQuadratic() const;
+  
+  /// Gets the kernel.
+  /// The kernel is resolved from the registry when name or julia exponent
+  /// changes, so a renderer can get it once for a frame, and call it
+  /// without any string matching. The mandelbrot set and quadratic julia
+  /// sets use the SIMD kernels from FractalSimd, other exponents use
+  /// scalar kernels specialized at compile time.
+  auto kernel() const {return m_kernel;};
+  
+  /// Gets the double-double kernel, or nullptr if the fractal
+  /// has no kernel in double-double precision.
+  auto kernelDoubleDouble() const {return m_kernelDoubleDouble;};
+  
+  /// Gets the float kernel, or nullptr if the fractal
+  /// has no kernel in float precision.
+  auto kernelFloat() const {return m_kernelFloat;};
+  
+  /// Gets the name.
+  const auto & name() const {return m_name;};
+  
+  /// Returns the cheapest precision that resolves the spacing between
+  /// pixels at the coordinates, and has a kernel for this fractal.
+  FractalPrecision precision(
+    /// largest absolute value of the coordinates
+    double magnitude,
+    /// spacing between pixels
+    double spacing) const;
+  
+  /// Returns the name of a precision.
+  static const char* precisionName(FractalPrecision precision);
+  
+  /// Sets diverge.
+  void setDiverge(double diverge) {m_diverge = diverge;};
+  
+  /// Sets julia.
+  void setJulia(const std::complex<double> julia) {m_julia = julia;};
+  
+  /// Sets julia exponent.
+  void setJuliaExponent(double exp);
+  
+  /// Update name.
+  bool setName(const std::string& name);
+
+  /// Sets the renderer.
+  /// Use this if you want to be able to interrupt fractal calculation.
+  void setRenderer(FractalRenderer* renderer) {m_renderer = renderer;};
+    
+  /// Gets the stats of the interior shortcuts of the kernels.
+  /// The mandelbrot set skips points in the main cardioid and period 2
+  /// bulb, all kernels stop when an orbit is at an attracting cycle.
+  auto & stats() const {return m_stats;};
+  
+  /// Supported fractals.
+  static std::vector<std::string> & names();
+private:  
+  bool interrupted() const;
+  template <typename T, typename Power>
+  static bool juliaset(
+    const Fractal& fractal,
+    const T* x, 
+    const T* y, 
+    int* n, 
+    int count, 
+    int max,
+    FractalOrbits<T>* orbits);
+  template <typename T>
+  static bool juliasetQuadratic(
+    const Fractal& fractal,
+    const T* x, 
+    const T* y, 
+    int* n, 
+    int count, 
+    int max,
+    FractalOrbits<T>* orbits);
+  template <typename T>
+  static bool mandelbrotset(
+    const Fractal& fractal,
+    const T* x, 
+    const T* y, 
+    int* n, 
+    int count, 
+    int max,
+    FractalOrbits<T>* orbits);
+  template <typename T>
+  static bool quadratic(
+    const Fractal& fractal,
+    const T* x, 
+    const T* y, 
+    int* n, 
+    int count, 
+    int max,
+    FractalOrbits<T>* orbits,
+    bool mandelbrot);
+  void setKernel();
+  void setKernels(
+    FractalKernel<float> kernelFloat,
+    FractalKernel<double> kernel,
+    FractalKernel<DoubleDouble> kernelDoubleDouble);
+  
+  FractalKernel<double> m_kernel = nullptr;
+  FractalKernel<DoubleDouble> m_kernelDoubleDouble = nullptr;
+  FractalKernel<float> m_kernelFloat = nullptr;
+  FractalRenderer* m_renderer = nullptr;
+  
+  mutable FractalStats m_stats;
+  
+  double m_diverge;
+  std::complex<double> m_julia;
+  double m_juliaExponent;
+  int m_type = -1;
+  std::string m_name;
+  static std::vector<std::string> m_names;
+};
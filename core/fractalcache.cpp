@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      fractalcache.cpp
+// Purpose:   Implementation of class FractalCache
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include "fractalcache.h"
+
+// The extension of frame files.
+const QString frame_extension = ".frame";
+
+bool FractalCache::find(FractalFrame& frame)
+{
+  const auto it = lookup(frame);
+
+  if (it == m_frames.end())
+  {
+    if (m_dir.isEmpty() || !frame.read(file(frame)))
+    {
+      return false;
+    }
+
+    // keeps the file as recently used
+    QFile f(file(frame));
+
+    if (f.open(QIODevice::ReadWrite))
+    {
+      f.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+
+    insert(frame);
+
+    return true;
+  }
+
+  // most recently used at the front
+  m_frames.splice(m_frames.begin(), m_frames, it);
+
+  FractalFrame cached(m_frames.front());
+  cached.expand();
+
+  return frame.translate(cached);
+}
+
+const QString FractalCache::file(const FractalFrame& frame) const
+{
+  return QDir(m_dir).filePath(frame.key() + frame_extension);
+}
+
+void FractalCache::insert(const FractalFrame& frame)
+{
+  if (m_size == 0)
+  {
+    return;
+  }
+
+  const auto it = lookup(frame);
+
+  if (it != m_frames.end())
+  {
+    m_memory -= it->memory();
+    m_frames.erase(it);
+  }
+
+  m_frames.push_front(frame);
+  m_frames.front().compress();
+  m_memory += m_frames.front().memory();
+
+  shrink();
+
+  if (!m_dir.isEmpty() && m_disk > 0 && !QFileInfo::exists(file(frame)))
+  {
+    m_frames.front().write(file(frame));
+    shrinkDisk();
+  }
+}
+
+std::list<FractalFrame>::iterator FractalCache::lookup(const FractalFrame& frame)
+{
+  int dx, dy;
+
+  for (auto it = m_frames.begin(); it != m_frames.end(); ++it)
+  {
+    if (frame.offset(*it, dx, dy) && dx == 0 && dy == 0)
+    {
+      return it;
+    }
+  }
+
+  return m_frames.end();
+}
+
+void FractalCache::setDisk(const QString& dir, size_t size)
+{
+  m_dir = dir;
+  m_disk = size;
+
+  if (!m_dir.isEmpty())
+  {
+    QDir().mkpath(m_dir);
+    shrinkDisk();
+  }
+}
+
+void FractalCache::setSize(size_t size)
+{
+  m_size = size;
+  shrink();
+}
+
+void FractalCache::shrink()
+{
+  while (!m_frames.empty() && m_memory > m_size)
+  {
+    m_memory -= m_frames.back().memory();
+    m_frames.pop_back();
+  }
+}
+
+void FractalCache::shrinkDisk()
+{
+  const auto files = QDir(m_dir).entryInfoList(
+    QStringList() << "*" + frame_extension, QDir::Files, QDir::Time);
+
+  size_t used = 0;
+
+  // newest first
+  for (const auto& info : files)
+  {
+    used += info.size();
+
+    if (used > m_disk)
+    {
+      QFile::remove(info.absoluteFilePath());
+    }
+  }
+}
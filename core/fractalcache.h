@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      fractalcache.h
+// Purpose:   Declaration of class FractalCache
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <list>
+#include <QDir>
+#include "fractalframe.h"
+
+/// This class offers a least recently used cache of finished frames,
+/// so zooming back or forward to a recently rendered view, e.g. using
+/// the zoom stack, only colours the image again.
+/// The frames are kept compressed, within a memory budget.
+/// Optionally the frames are also kept on disk across sessions, as
+/// files named by the key of the frame, within a disk budget, the least
+/// recently used files are removed first.
+class FractalCache
+{
+public:
+  /// Constructor.
+  FractalCache(
+    /// memory budget in bytes, 0 disables the cache
+    size_t size = 64 * 1024 * 1024)
+    : m_size(size) {;};
+
+  /// Gets the dir for frames on disk.
+  const auto & dir() const {return m_dir;};
+
+  /// Returns disk budget in bytes.
+  auto disk() const {return m_disk;};
+
+  /// Finds a frame with the view of the frame, within half a step,
+  /// and copies its counts into the frame, moving its view to the
+  /// cached view. On disk only the exact view is found.
+  /// Returns true if found.
+  bool find(FractalFrame& frame);
+
+  /// Inserts a finished frame, replacing a frame with the same view.
+  /// The least recently used frames are removed if the memory budget
+  /// is exceeded.
+  void insert(const FractalFrame& frame);
+
+  /// Returns memory used in bytes.
+  auto memory() const {return m_memory;};
+
+  /// Sets dir and budget in bytes for frames on disk,
+  /// an empty dir disables frames on disk.
+  void setDisk(const QString& dir, size_t size);
+
+  /// Sets memory budget in bytes.
+  void setSize(size_t size);
+
+  /// Returns memory budget in bytes.
+  auto size() const {return m_size;};
+private:
+  const QString file(const FractalFrame& frame) const;
+  std::list<FractalFrame>::iterator lookup(const FractalFrame& frame);
+  void shrink();
+  void shrinkDisk();
+
+  std::list<FractalFrame> m_frames;
+
+  QString m_dir;
+
+  size_t m_disk = 0;
+  size_t m_memory = 0;
+  size_t m_size;
+};
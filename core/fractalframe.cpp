@@ -0,0 +1,928 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      fractalframe.cpp
+// Purpose:   Implementation of class FractalFrame
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QSaveFile>
+#include "fractalframe.h"
+#include "fractal.h"
+#include "fractalgeometry.h"
+
+// The header of a frame file, followed by the parameters, a line
+// for each one padded to 4 bytes, and the runs.
+struct FrameHeader
+{
+  char m_magic[4];
+  qint32 m_version;
+  qint32 m_width, m_height;
+  qint32 m_incWidth, m_incHeight;
+  qint32 m_parameters;
+  qint32 m_runs;
+  qint64 m_stats[FractalStats::SHORTCUT_MAX];
+};
+
+// The header of a native frame file, followed by sections at offsets
+// aligned to 64 bytes, so they are used in place when the file is mapped,
+// an offset of 0 is a section that is not present (see README).
+struct NativeHeader
+{
+  char m_magic[4];
+  qint32 m_version;
+  qint32 m_width, m_height;
+  qint32 m_incWidth, m_incHeight;
+  qint32 m_orbitScalar, m_orbitCount;
+  qint64 m_parameters, m_parametersSize;
+  qint64 m_counts;
+  qint64 m_orbitSteps, m_orbitValues;
+  qint64 m_distances;
+  qint64 m_stats[FractalStats::SHORTCUT_MAX];
+};
+
+const char frame_magic[4] = {'F', 'R', 'M', 'C'};
+const qint32 frame_version = 3;
+const char native_magic[4] = {'F', 'R', 'M', 'N'};
+const qint32 native_version = 2;
+const qint64 native_align = 64;
+
+// Appends a part of an orbit to the values, as a scalar of bytes.
+static void appendScalar(
+  std::vector<char>& values, int bytes, const DoubleDouble& value)
+{
+  const float f = value.hi();
+  const double d = value.hi();
+  const char* data = (
+    bytes == sizeof(float) ? (const char*)&f: 
+    bytes == sizeof(double) ? (const char*)&d: (const char*)&value);
+  
+  values.insert(values.end(), data, data + bytes);
+}
+
+// Gets the stats kept in a header.
+static FractalStats readStats(const qint64* counts)
+{
+  FractalStats stats;
+
+  for (int i = 0; i < FractalStats::SHORTCUT_MAX; i++)
+  {
+    stats.add((FractalStats::Shortcut)i, counts[i]);
+  }
+
+  return stats;
+}
+
+// Gets a part of an orbit from the values, a float or double
+// is kept exactly in the high part.
+static DoubleDouble scalarAt(const char* values, int bytes)
+{
+  switch (bytes)
+  {
+    case sizeof(float):
+    {
+      float f;
+      std::memcpy(&f, values, sizeof(f));
+      return DoubleDouble(f);
+    }
+    
+    case sizeof(double):
+    {
+      double d;
+      std::memcpy(&d, values, sizeof(d));
+      return DoubleDouble(d);
+    }
+    
+    default:
+    {
+      DoubleDouble dd;
+      std::memcpy((void*)&dd, values, sizeof(dd));
+      return dd;
+    }
+  }
+}
+
+// Sets the stats kept in a header.
+static void writeStats(const FractalStats& stats, qint64* counts)
+{
+  for (int i = 0; i < FractalStats::SHORTCUT_MAX; i++)
+  {
+    counts[i] = stats.count((FractalStats::Shortcut)i);
+  }
+}
+
+FractalFrame::FractalFrame(
+  const Fractal& fractal,
+  const FractalGeometry& geo,
+  const QSize& size,
+  const QSize& inc)
+  : m_inc(inc)
+  , m_size(size)
+  , m_columns((size.width() + inc.width() - 1) / inc.width())
+  , m_name(fractal.name())
+  , m_diverge(fractal.diverge())
+  , m_julia(fractal.julia())
+  , m_juliaExponent(fractal.juliaExponent())
+  , m_centerX(geo.centerX())
+  , m_centerY(geo.centerY())
+  , m_width(geo.width())
+  , m_height(geo.height())
+  , m_depth(geo.depth())
+  , m_guess(geo.guess())
+{
+  const int rows = (size.height() + inc.height() - 1) / inc.height();
+
+  m_counts.assign(m_columns * rows, not_calculated);
+}
+
+void FractalFrame::addOrbit(const QPoint& p, float zr, float zi)
+{
+  addOrbit(p, sizeof(float), DoubleDouble(zr), DoubleDouble(zi));
+}
+
+void FractalFrame::addOrbit(const QPoint& p, double zr, double zi)
+{
+  addOrbit(p, sizeof(double), DoubleDouble(zr), DoubleDouble(zi));
+}
+
+void FractalFrame::addOrbit(const QPoint& p, 
+  const DoubleDouble& zr, const DoubleDouble& zi)
+{
+  addOrbit(p, sizeof(DoubleDouble), zr, zi);
+}
+
+void FractalFrame::addOrbit(const QPoint& p, int scalar,
+  const DoubleDouble& zr, const DoubleDouble& zi)
+{
+  // The orbits of an opened file are copied before they are changed.
+  if (m_orbits->m_mappedSteps != nullptr)
+  {
+    const auto mapped = m_orbits;
+    
+    m_orbits = std::make_shared<Orbits>();
+    m_orbits->m_scalar = mapped->m_scalar;
+    m_orbits->m_steps.assign(
+      mapped->steps(), mapped->steps() + mapped->size());
+    m_orbits->m_values.assign(mapped->values(), 
+      mapped->values() + 2 * mapped->size() * mapped->m_scalar);
+  }
+  
+  // All steps of a frame use the same kernel, the orbits
+  // keep the scalar of the first one.
+  if (m_orbits->m_steps.empty())
+  {
+    m_orbits->m_scalar = scalar;
+  }
+  
+  m_orbits->m_steps.push_back(index(p));
+  appendScalar(m_orbits->m_values, m_orbits->m_scalar, zr);
+  appendScalar(m_orbits->m_values, m_orbits->m_scalar, zi);
+}
+
+void FractalFrame::colour(
+  const FractalGeometry& geo,
+  QImage& image,
+  const QRect& tile,
+  int block) const
+{
+  const int bw = block * m_inc.width();
+  const int bh = block * m_inc.height();
+
+  if (!geo.useImages())
+  {
+    // A step is a pixel, each row is written through its scan line.
+    // Any negative count is not calculated, see not_calculated.
+    const auto& colours = geo.colours();
+
+    for (int y = tile.top(); y <= tile.bottom(); y++)
+    {
+      const int* counts = this->counts() + index(QPoint(0, y));
+      const int* origins = this->counts() + 
+        index(QPoint(0, tile.top() + (y - tile.top()) / bh * bh));
+      auto* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+
+      for (int x = tile.left(); x <= tile.right(); x++)
+      {
+        const int n = (counts[x] >= 0 ? counts[x]:
+          origins[tile.left() + (x - tile.left()) / bw * bw]);
+
+        if (n >= 0)
+        {
+          line[x] = (n < geo.depth() ? 
+            colours[n % colours.size()]: colours.back());
+        }
+      }
+    }
+
+    return;
+  }
+
+  // Images larger than a step cover the steps right and below them,
+  // and are covered by the images of those steps, as when the image
+  // is stamped step after step. So the steps before the tile with images
+  // reaching into it are stamped as well, only the tile is written.
+  QSize overlap(0, 0);
+
+  for (const auto& i : geo.images())
+  {
+    overlap = overlap.expandedTo(i.size() - m_inc);
+  }
+
+  const int left = std::max(0, tile.left() -
+    (overlap.width() + m_inc.width() - 1) / m_inc.width() * m_inc.width());
+  const int top = std::max(0, tile.top() -
+    (overlap.height() + m_inc.height() - 1) / m_inc.height() * m_inc.height());
+
+  for (int y = top; y <= tile.bottom(); y += m_inc.height())
+  {
+    for (int x = left; x <= tile.right(); x += m_inc.width())
+    {
+      const QPoint p(x, y);
+      int n = count(p);
+
+      if (n < 0 && block > 1 && tile.contains(p))
+      {
+        n = count(QPoint(
+          tile.left() + (x - tile.left()) / bw * bw,
+          tile.top() + (y - tile.top()) / bh * bh));
+      }
+
+      if (n >= 0)
+      {
+        stamp(geo, image, p, tile, n);
+      }
+    }
+  }
+}
+
+void FractalFrame::compress()
+{
+  // Run length encoded, as pairs of a length and a count.
+  m_runs.clear();
+
+  const int* last = counts() + steps();
+
+  for (const int* it = counts(); it != last;)
+  {
+    const auto end = std::find_if(it, last, [&](int n) {return n != *it;});
+
+    m_runs.push_back(end - it);
+    m_runs.push_back(*it);
+    it = end;
+  }
+
+  m_runs.shrink_to_fit();
+  m_counts.clear();
+  m_counts.shrink_to_fit();
+  m_orbits.reset();
+  m_resumed.reset();
+  m_start = 0;
+  m_file.reset();
+  m_mappedCounts = nullptr;
+  m_mappedSteps = 0;
+}
+
+void FractalFrame::expand()
+{
+  if (m_runs.empty())
+  {
+    return;
+  }
+
+  for (size_t i = 0; i < m_runs.size(); i += 2)
+  {
+    m_counts.insert(m_counts.end(), m_runs[i], m_runs[i + 1]);
+  }
+
+  m_runs.clear();
+  m_runs.shrink_to_fit();
+}
+
+bool FractalFrame::isCalculated(const QRect& tile, int block) const
+{
+  for (int y = tile.top(); y <= tile.bottom(); y += block * m_inc.height())
+  {
+    for (int x = tile.left(); x <= tile.right(); x += block * m_inc.width())
+    {
+      if (count(QPoint(x, y)) < 0)
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+QString FractalFrame::key() const
+{
+  const std::string text = 
+    parameters() +
+    std::to_string(m_size.width()) + "x" + std::to_string(m_size.height()) + " " +
+    std::to_string(m_inc.width()) + "x" + std::to_string(m_inc.height());
+
+  return QCryptographicHash::hash(
+    QByteArray(text.c_str(), text.size()), QCryptographicHash::Sha1).toHex();
+}
+
+bool FractalFrame::load(const QString& file)
+{
+  return read(file, true);
+}
+
+bool FractalFrame::matches(
+  const Fractal& fractal,
+  const FractalGeometry& geo,
+  const QSize& size,
+  const QSize& inc) const
+{
+  return
+    steps() > 0 &&
+    m_size == size &&
+    m_inc == inc &&
+    m_name == fractal.name() &&
+    m_diverge == fractal.diverge() &&
+    m_julia == fractal.julia() &&
+    m_juliaExponent == fractal.juliaExponent() &&
+    m_centerX == geo.centerX() &&
+    m_centerY == geo.centerY() &&
+    m_width == geo.width() &&
+    m_height == geo.height() &&
+    m_depth == geo.depth() &&
+    (!m_guess || geo.guess());
+}
+
+bool FractalFrame::offset(const FractalFrame& other, int& dx, int& dy) const
+{
+  if (
+    other.m_size != m_size ||
+    other.m_inc != m_inc ||
+    other.m_name != m_name ||
+    other.m_diverge != m_diverge ||
+    other.m_julia != m_julia ||
+    other.m_juliaExponent != m_juliaExponent ||
+    other.m_depth != m_depth ||
+    (other.m_guess && !m_guess))
+  {
+    return false;
+  }
+
+  // The scale may differ by rounding noise of the intervals,
+  // as long as it moves the pixels less than half a pixel.
+  const double tolerance = 0.5 / std::max(m_size.width(), m_size.height());
+
+  if (std::fabs(m_width - other.m_width) > tolerance * m_width ||
+      std::fabs(m_height - other.m_height) > tolerance * m_height)
+  {
+    return false;
+  }
+
+  const int rows = (m_size.height() + m_inc.height() - 1) / m_inc.height();
+  const double sx = (m_centerX - other.m_centerX).toDouble() / 
+    (other.m_width * m_inc.width() / m_size.width());
+  const double sy = (m_centerY - other.m_centerY).toDouble() / 
+    (other.m_height * m_inc.height() / m_size.height());
+
+  if (std::fabs(sx) >= m_columns || std::fabs(sy) >= rows)
+  {
+    return false;
+  }
+
+  // The imag axis points up.
+  dx = std::lround(sx);
+  dy = -std::lround(sy);
+
+  return true;
+}
+
+bool FractalFrame::open(const QString& file)
+{
+  auto f = std::make_shared<QFile>(file);
+
+  if (!f->open(QIODevice::ReadOnly) || f->size() < (qint64)sizeof(NativeHeader))
+  {
+    return false;
+  }
+
+  // A private mapping, so the counts and orbits can be changed, e.g. when
+  // the steps not yet calculated are continued, without writing the file.
+  uchar* data = f->map(0, f->size(), QFileDevice::MapPrivateOption);
+
+  if (data == nullptr)
+  {
+    return false;
+  }
+
+  const auto* header = reinterpret_cast<const NativeHeader*>(data);
+  const QSize size(header->m_width, header->m_height);
+  const QSize inc(header->m_incWidth, header->m_incHeight);
+
+  if (
+    !std::equal(native_magic, native_magic + 4, header->m_magic) ||
+    header->m_version != native_version ||
+    size.isEmpty() || inc.isEmpty())
+  {
+    return false;
+  }
+
+  // The counts are used in place, they are not checked here (see colour).
+
+  const int columns = (size.width() + inc.width() - 1) / inc.width();
+  const qint64 steps = 
+    (qint64)columns * ((size.height() + inc.height() - 1) / inc.height());
+
+  // Returns true if a section is inside the file and aligned.
+  const auto fits = [&](qint64 offset, qint64 bytes) {
+    return 
+      offset >= (qint64)sizeof(NativeHeader) && 
+      offset % native_align == 0 &&
+      bytes >= 0 && offset + bytes <= f->size();};
+
+  const qint64 orbits = header->m_orbitCount;
+  const int scalar = header->m_orbitScalar;
+  FractalFrame frame;
+
+  if (
+    !fits(header->m_parameters, header->m_parametersSize) ||
+    !fits(header->m_counts, steps * (qint64)sizeof(qint32)) ||
+    (header->m_orbitSteps != 0 && 
+     (orbits < 0 || orbits > steps ||
+      (orbits > 0 && scalar != sizeof(float) && scalar != sizeof(double) && 
+       scalar != sizeof(DoubleDouble)) ||
+      !fits(header->m_orbitSteps, orbits * (qint64)sizeof(qint32)) ||
+      !fits(header->m_orbitValues, 2 * orbits * scalar))) ||
+    !frame.setParameters(std::string(
+      (const char*)data + header->m_parameters, header->m_parametersSize)))
+  {
+    return false;
+  }
+
+  // The orbits are used in place as well, they are only used 
+  // to continue the frame, and checked then (see resume).
+  if (header->m_orbitSteps != 0)
+  {
+    frame.m_orbits = std::make_shared<Orbits>();
+    frame.m_orbits->m_scalar = scalar;
+    frame.m_orbits->m_file = f;
+    frame.m_orbits->m_mappedSteps = 
+      reinterpret_cast<const qint32*>(data + header->m_orbitSteps);
+    frame.m_orbits->m_mappedValues = 
+      (const char*)data + header->m_orbitValues;
+    frame.m_orbits->m_mappedCount = orbits;
+  }
+
+  frame.m_size = size;
+  frame.m_inc = inc;
+  frame.m_columns = columns;
+  frame.m_stats = readStats(header->m_stats);
+  frame.m_mappedCounts = reinterpret_cast<int*>(data + header->m_counts);
+  frame.m_mappedSteps = steps;
+  frame.m_file = std::move(f);
+
+  *this = std::move(frame);
+
+  return true;
+}
+
+bool FractalFrame::orbit(
+  const QPoint& p, DoubleDouble& zr, DoubleDouble& zi) const
+{
+  if (m_resumed == nullptr)
+  {
+    return false;
+  }
+
+  const auto* steps = m_resumed->steps();
+  const auto* last = steps + m_resumed->size();
+  const auto* it = std::lower_bound(steps, last, index(p));
+
+  if (it == last || *it != index(p))
+  {
+    return false;
+  }
+
+  const int scalar = m_resumed->m_scalar;
+  const char* value = m_resumed->values() + 2 * (it - steps) * scalar;
+
+  zr = scalarAt(value, scalar);
+  zi = scalarAt(value + scalar, scalar);
+
+  return true;
+}
+
+std::shared_ptr<const FractalFrame::Orbits> FractalFrame::orbits() const
+{
+  // The tiles add their orbits in any order, and a file may have them
+  // in any order, a sorted copy is made when they are used, 
+  // the orbits added are not changed.
+  if (m_orbits == nullptr || std::is_sorted(
+    m_orbits->steps(), m_orbits->steps() + m_orbits->size()))
+  {
+    return m_orbits;
+  }
+
+  const auto* steps = m_orbits->steps();
+  const auto* values = m_orbits->values();
+  std::vector<int> order(m_orbits->size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](int a, int b) {
+    return steps[a] < steps[b];});
+
+  auto sorted = std::make_shared<Orbits>();
+  const int bytes = 2 * m_orbits->m_scalar;
+
+  sorted->m_scalar = m_orbits->m_scalar;
+  sorted->m_steps.reserve(order.size());
+  sorted->m_values.reserve(order.size() * bytes);
+
+  for (const int i : order)
+  {
+    sorted->m_steps.push_back(steps[i]);
+    sorted->m_values.insert(sorted->m_values.end(),
+      values + i * bytes, values + (i + 1) * bytes);
+  }
+
+  return sorted;
+}
+
+std::string FractalFrame::parameters() const
+{
+  // The center is exact, using 32 digits for each limb,
+  // the doubles use 17 digits.
+  const auto number = [](double value) {
+    return QByteArray::number(value, 'g', 17).toStdString();};
+
+  return 
+    m_name + "\n" +
+    number(m_diverge) + "\n" +
+    number(m_julia.real()) + "\n" +
+    number(m_julia.imag()) + "\n" +
+    number(m_juliaExponent) + "\n" +
+    std::to_string(m_centerX.limbs()) + "\n" +
+    m_centerX.toString(32 * m_centerX.limbs()) + "\n" +
+    std::to_string(m_centerY.limbs()) + "\n" +
+    m_centerY.toString(32 * m_centerY.limbs()) + "\n" +
+    number(m_width) + "\n" +
+    number(m_height) + "\n" +
+    std::to_string(m_depth) + "\n" +
+    std::to_string(m_guess) + "\n";
+}
+
+bool FractalFrame::read(const QString& file)
+{
+  return read(file, false);
+}
+
+bool FractalFrame::read(const QString& file, bool load)
+{
+  QFile f(file);
+
+  if (!f.open(QIODevice::ReadOnly) || f.size() < (qint64)sizeof(FrameHeader))
+  {
+    return false;
+  }
+
+  const uchar* data = f.map(0, f.size());
+
+  if (data == nullptr)
+  {
+    return false;
+  }
+
+  const auto* header = reinterpret_cast<const FrameHeader*>(data);
+  const qint64 parameters = ((qint64)header->m_parameters + 3) / 4 * 4;
+  const QSize size(header->m_width, header->m_height);
+  const QSize inc(header->m_incWidth, header->m_incHeight);
+
+  if (
+    !std::equal(frame_magic, frame_magic + 4, header->m_magic) ||
+    header->m_version != frame_version ||
+    header->m_parameters < 0 || header->m_runs < 0 ||
+    f.size() != (qint64)(sizeof(FrameHeader) + parameters + 
+      2 * (qint64)header->m_runs * sizeof(qint32)))
+  {
+    return false;
+  }
+
+  const std::string text(
+    (const char*)data + sizeof(FrameHeader), header->m_parameters);
+  const auto* runs = reinterpret_cast<const qint32*>(
+    data + sizeof(FrameHeader) + parameters);
+
+  // A loaded frame takes the parameters and size of the file.
+  FractalFrame loaded;
+  FractalFrame& frame(load ? loaded: *this);
+
+  if (load)
+  {
+    if (size.isEmpty() || inc.isEmpty() || !loaded.setParameters(text))
+    {
+      return false;
+    }
+
+    loaded.m_size = size;
+    loaded.m_inc = inc;
+    loaded.m_columns = (size.width() + inc.width() - 1) / inc.width();
+    loaded.m_counts.assign(loaded.m_columns * 
+      ((size.height() + inc.height() - 1) / inc.height()), not_calculated);
+  }
+  else if (size != m_size || inc != m_inc || text != this->parameters())
+  {
+    return false;
+  }
+
+  std::vector<int> counts;
+  counts.reserve(frame.m_counts.size());
+
+  for (int i = 0; i < header->m_runs; i++)
+  {
+    if (runs[2 * i] < 0 || 
+        counts.size() + runs[2 * i] > frame.m_counts.size() ||
+        runs[2 * i + 1] < not_calculated || runs[2 * i + 1] > frame.m_depth)
+    {
+      return false;
+    }
+
+    counts.insert(counts.end(), runs[2 * i], runs[2 * i + 1]);
+  }
+
+  if (counts.size() != frame.m_counts.size())
+  {
+    return false;
+  }
+
+  frame.m_counts.swap(counts);
+  frame.m_stats = readStats(header->m_stats);
+
+  if (load)
+  {
+    *this = std::move(loaded);
+  }
+
+  return true;
+}
+
+bool FractalFrame::resume(const FractalFrame& other)
+{
+  if (
+    !other.isResumable() ||
+    other.m_size != m_size ||
+    other.m_inc != m_inc ||
+    other.m_name != m_name ||
+    other.m_diverge != m_diverge ||
+    other.m_julia != m_julia ||
+    other.m_juliaExponent != m_juliaExponent ||
+    other.m_centerX != m_centerX ||
+    other.m_centerY != m_centerY ||
+    other.m_width != m_width ||
+    other.m_height != m_height ||
+    other.m_depth >= m_depth ||
+    m_guess ||
+    std::any_of(other.counts(), other.counts() + other.steps(), 
+      [&](int n) {return n < 0 || n > other.m_depth;}))
+  {
+    return false;
+  }
+
+  // Each step that reached the depth of the other frame has one orbit,
+  // the orbits of an opened file are checked here.
+  const auto orbits = other.orbits();
+  const auto* steps = orbits->steps();
+  const auto* last = steps + orbits->size();
+
+  if (
+    (size_t)std::count(other.counts(), other.counts() + other.steps(), 
+      other.m_depth) != orbits->size() ||
+    std::adjacent_find(steps, last, std::greater_equal<>()) != last ||
+    std::any_of(steps, last, [&](qint32 step) {
+      return 
+        step < 0 || step >= other.steps() || 
+        other.counts()[step] != other.m_depth;}))
+  {
+    return false;
+  }
+
+  // Steps that reached the depth of the other frame are calculated again,
+  // starting at their orbits.
+  std::transform(other.counts(), other.counts() + other.steps(), counts(),
+    [&](int n) {return n < other.m_depth ? n: not_calculated;});
+
+  m_resumed = orbits;
+  m_start = other.m_depth;
+
+  return true;
+}
+
+bool FractalFrame::save(const QString& file) const
+{
+  if (steps() == 0)
+  {
+    return false;
+  }
+
+  const auto align = [](qint64 offset) {
+    return (offset + native_align - 1) / native_align * native_align;};
+
+  const std::string text(parameters());
+  const qint64 counts = steps() * (qint64)sizeof(qint32);
+  const auto orbits = this->orbits();
+
+  NativeHeader header{};
+  std::copy(native_magic, native_magic + 4, header.m_magic);
+  header.m_version = native_version;
+  header.m_width = m_size.width();
+  header.m_height = m_size.height();
+  header.m_incWidth = m_inc.width();
+  header.m_incHeight = m_inc.height();
+  header.m_parameters = align(sizeof(header));
+  header.m_parametersSize = text.size();
+  header.m_counts = align(header.m_parameters + header.m_parametersSize);
+  writeStats(m_stats, header.m_stats);
+
+  if (orbits != nullptr)
+  {
+    header.m_orbitScalar = orbits->m_scalar;
+    header.m_orbitCount = orbits->size();
+    header.m_orbitSteps = align(header.m_counts + counts);
+    header.m_orbitValues = align(header.m_orbitSteps + 
+      orbits->size() * (qint64)sizeof(qint32));
+  }
+
+  QSaveFile f(file);
+
+  // Writes zeros up to the offset of a section, and the section.
+  const auto section = [&](qint64 offset, const void* data, qint64 bytes) {
+    const QByteArray pad(offset - f.pos(), '\0');
+    return
+      f.write(pad) == pad.size() &&
+      f.write((const char*)data, bytes) == bytes;};
+
+  return 
+    f.open(QIODevice::WriteOnly) &&
+    f.write((const char*)&header, sizeof(header)) == sizeof(header) &&
+    section(header.m_parameters, text.data(), text.size()) &&
+    section(header.m_counts, this->counts(), counts) &&
+    (orbits == nullptr || 
+     (section(header.m_orbitSteps, orbits->steps(), 
+        orbits->size() * (qint64)sizeof(qint32)) &&
+      section(header.m_orbitValues, orbits->values(), 
+        2 * orbits->size() * (qint64)orbits->m_scalar))) &&
+    f.commit();
+}
+
+bool FractalFrame::setParameters(const std::string& text)
+{
+  std::vector<QByteArray> lines;
+  size_t pos = 0;
+
+  for (size_t end = text.find('\n'); end != std::string::npos; 
+    pos = end + 1, end = text.find('\n', pos))
+  {
+    lines.push_back(QByteArray::fromStdString(text.substr(pos, end - pos)));
+  }
+
+  if (lines.size() != 13)
+  {
+    return false;
+  }
+
+  const int limbsX = lines[5].toInt();
+  const int limbsY = lines[7].toInt();
+
+  if (limbsX < 1 || limbsY < 1)
+  {
+    return false;
+  }
+
+  m_name = lines[0].toStdString();
+  m_diverge = lines[1].toDouble();
+  m_julia = std::complex<double>(lines[2].toDouble(), lines[3].toDouble());
+  m_juliaExponent = lines[4].toDouble();
+  m_centerX = BigReal::fromString(lines[6].toStdString(), limbsX);
+  m_centerY = BigReal::fromString(lines[8].toStdString(), limbsY);
+  m_width = lines[9].toDouble();
+  m_height = lines[10].toDouble();
+  m_depth = lines[11].toInt();
+  m_guess = lines[12].toInt();
+
+  return true;
+}
+
+void FractalFrame::setResumable(bool resumable)
+{
+  if (!resumable)
+  {
+    m_orbits.reset();
+  }
+  else if (!isResumable())
+  {
+    m_orbits = std::make_shared<Orbits>();
+  }
+}
+
+void FractalFrame::stamp(
+  const FractalGeometry& geo,
+  QImage& image,
+  const QPoint& p,
+  const QRect& tile,
+  int n) const
+{
+  const int ii = (n < geo.depth() ? 
+    (n % geo.images().size()): geo.images().size() - 1);
+  
+  // The images are converted when loaded, see FractalControl::setImages.
+  const QImage stamp(geo.image(ii).format() == image.format() ?
+    geo.image(ii): geo.image(ii).convertToFormat(image.format()));
+  
+  // Clipped once, then each row is copied at once.
+  const QRect rect(QRect(p, stamp.size()).intersected(tile));
+
+  for (int y = rect.top(); y <= rect.bottom(); y++)
+  {
+    const auto* from = 
+      reinterpret_cast<const QRgb*>(stamp.constScanLine(y - p.y()));
+    
+    std::copy_n(from + rect.left() - p.x(), rect.width(), 
+      reinterpret_cast<QRgb*>(image.scanLine(y)) + rect.left());
+  }
+}
+
+bool FractalFrame::translate(const FractalFrame& other)
+{
+  int dx, dy;
+
+  if (other.steps() == 0 || !offset(other, dx, dy))
+  {
+    return false;
+  }
+
+  const int limbs = std::max(m_centerX.limbs(), m_centerY.limbs());
+  const int rows = steps() / m_columns;
+
+  m_centerX = other.m_centerX + 
+    BigReal(dx * other.m_width * m_inc.width() / m_size.width(), limbs);
+  m_centerY = other.m_centerY - 
+    BigReal(dy * other.m_height * m_inc.height() / m_size.height(), limbs);
+  m_width = other.m_width;
+  m_height = other.m_height;
+
+  // The stats only belong to the steps copied if all are copied.
+  if (dx == 0 && dy == 0)
+  {
+    m_stats = other.m_stats;
+  }
+
+  // Step (i, j) is step (i + dx, j + dy) of the other frame.
+  for (int j = std::max(0, -dy); j < std::min(rows, rows - dy); j++)
+  {
+    std::copy(
+      other.counts() + (j + dy) * m_columns + std::max(0, dx),
+      other.counts() + (j + dy) * m_columns + std::min(m_columns, m_columns + dx),
+      counts() + j * m_columns + std::max(0, -dx));
+  }
+
+  return true;
+}
+
+bool FractalFrame::write(const QString& file) const
+{
+  FractalFrame frame(*this);
+
+  if (frame.m_runs.empty())
+  {
+    frame.compress();
+  }
+
+  std::string text(parameters());
+
+  FrameHeader header;
+  std::copy(frame_magic, frame_magic + 4, header.m_magic);
+  header.m_version = frame_version;
+  header.m_width = m_size.width();
+  header.m_height = m_size.height();
+  header.m_incWidth = m_inc.width();
+  header.m_incHeight = m_inc.height();
+  header.m_parameters = text.size();
+  header.m_runs = frame.m_runs.size() / 2;
+  writeStats(m_stats, header.m_stats);
+
+  // The runs are aligned.
+  text.resize((text.size() + 3) / 4 * 4, '\0');
+
+  // The file is replaced at commit, so a file being written,
+  // e.g. a checkpoint, never leaves a partial file.
+  QSaveFile f(file);
+
+  return 
+    f.open(QIODevice::WriteOnly) &&
+    f.write((const char*)&header, sizeof(header)) == sizeof(header) &&
+    f.write(text.data(), text.size()) == (qint64)text.size() &&
+    f.write((const char*)frame.m_runs.data(), frame.m_runs.size() * sizeof(int)) ==
+      (qint64)(frame.m_runs.size() * sizeof(int)) &&
+    f.commit();
+}
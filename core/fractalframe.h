@@ -0,0 +1,314 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      fractalframe.h
+// Purpose:   Declaration of class FractalFrame
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include "bigreal.h"
+#include "doubledouble.h"
+#include "fractal.h"
+
+class FractalGeometry;
+class QFile;
+
+/// This class keeps the iteration counts of an image, one count
+/// for each step (a pixel, or an image stamp when using images),
+/// together with the fractal and view they were calculated for.
+/// Colouring is a separate pass over the counts, so changing the
+/// colours or images only colours the image again, without any
+/// fractal calculation.
+/// A resumable frame also keeps the orbit of each step that reached
+/// the depth, in the scalar type of the kernel, so a higher depth
+/// continues these steps (see resume).
+/// A frame is written run length encoded (see write), e.g. for the cache
+/// and checkpoints, or in native format (see save), that is used in place
+/// when opened.
+class FractalFrame
+{
+public:
+  /// Count of a step that is not yet calculated, any negative count
+  /// is taken as not calculated, e.g. in an opened file.
+  static constexpr int not_calculated = -1;
+
+  /// Default constructor, an empty frame.
+  FractalFrame() {;};
+
+  /// Constructor, no step is calculated.
+  FractalFrame(
+    /// the fractal
+    const Fractal& fractal,
+    /// the geometry
+    const FractalGeometry& geo,
+    /// size of the image
+    const QSize& size,
+    /// size of a step
+    const QSize& inc);
+
+  /// Adds the orbit of a step that reached the depth, in float,
+  /// for a resumable frame. Orbits are added in any order, 
+  /// but not from several threads at the same time.
+  void addOrbit(const QPoint& p, float zr, float zi);
+
+  /// Adds the orbit of a step that reached the depth, in double.
+  void addOrbit(const QPoint& p, double zr, double zi);
+
+  /// Adds the orbit of a step that reached the depth, in double-double.
+  void addOrbit(const QPoint& p, 
+    const DoubleDouble& zr, const DoubleDouble& zi);
+
+  /// Adds the stats of steps calculated for this frame.
+  void addStats(const FractalStats& stats) {m_stats.add(stats);};
+
+  /// Gets real part of the view center.
+  const auto & centerX() const {return m_centerX;};
+
+  /// Gets imag part of the view center.
+  const auto & centerY() const {return m_centerY;};
+
+  /// Colours all calculated steps of a tile into the image.
+  /// A step that is not calculated gets the colour of the first step
+  /// of its block, if that one is calculated.
+  /// Images larger than a step cover the steps right and below them,
+  /// also from the tiles left and above, only the tile is written.
+  /// The image must have 32 bits per pixel, rows are written through
+  /// their scan lines, and images are copied a row at a time.
+  void colour(
+    /// the geometry, supplies colours or images
+    const FractalGeometry& geo,
+    /// the image
+    QImage& image,
+    /// the tile
+    const QRect& tile,
+    /// size of a block in steps, blocks start at the tile
+    int block = 1) const;
+
+  /// Compresses the counts, use expand before accessing them.
+  /// The orbits are not kept, the frame is no longer resumable,
+  /// and does not continue another one, and an opened file is closed.
+  void compress();
+
+  /// Returns count of the step at pixel p.
+  int count(const QPoint& p) const {return counts()[index(p)];};
+
+  /// Gets depth.
+  auto depth() const {return m_depth;};
+
+  /// Gets diverge limit.
+  auto diverge() const {return m_diverge;};
+
+  /// Expands the counts after compress.
+  void expand();
+
+  /// Gets height of the view.
+  auto height() const {return m_height;};
+
+  /// Gets size of a step.
+  const auto & inc() const {return m_inc;};
+
+  /// Gets guess.
+  auto guess() const {return m_guess;};
+
+  /// Returns true if the first step of all blocks of the tile
+  /// is calculated.
+  bool isCalculated(const QRect& tile, int block = 1) const;
+
+  /// Returns true if the orbits are kept.
+  bool isResumable() const {return m_orbits != nullptr;};
+
+  /// Returns true if this frame was calculated for the fractal,
+  /// view, depth and size, so the counts can be used again.
+  /// Guessed counts are only used again when guessing.
+  bool matches(
+    const Fractal& fractal,
+    const FractalGeometry& geo,
+    const QSize& size,
+    const QSize& inc) const;
+
+  /// Gets julia arg.
+  const auto & julia() const {return m_julia;};
+
+  /// Gets julia exponent.
+  auto juliaExponent() const {return m_juliaExponent;};
+
+  /// Returns a key for the fractal, view, depth and size,
+  /// a hash that is the same in each session.
+  QString key() const;
+
+  /// Reads a frame from a file written by write, taking the fractal,
+  /// view, depth and size from the file, e.g. to continue a checkpoint.
+  /// Returns false if the file is not a frame file.
+  bool load(const QString& file);
+
+  /// Gets name of the fractal.
+  const auto & name() const {return m_name;};
+
+  /// Returns memory used in bytes, an opened file and the orbits
+  /// of the frame resumed are not counted.
+  size_t memory() const {return sizeof(*this) + 
+    (m_counts.capacity() + m_runs.capacity()) * sizeof(int) +
+    (m_orbits != nullptr ? m_orbits->memory(): 0);};
+
+  /// Opens a frame from a file written by save, taking the fractal,
+  /// view, depth and size from the file. The file is mapped into memory
+  /// and its counts and orbits are used in place, so opening takes 
+  /// the same time for any size. Changes to them are private to the 
+  /// process, the file is not changed. Only the header is checked, 
+  /// negative counts are steps not calculated (see not_calculated),
+  /// and the orbits are checked when the frame is resumed (see resume).
+  /// Returns false if the file is not a native frame file.
+  bool open(const QString& file);
+
+  /// Gets the orbit of the step at pixel p of the frame resumed,
+  /// real and imag part, see start.
+  /// Returns false if the step has no orbit.
+  bool orbit(const QPoint& p, DoubleDouble& zr, DoubleDouble& zi) const;
+
+  /// Returns true if this frame is a translation of the other frame
+  /// at the same scale, and sets the translation in whole steps,
+  /// this view being at step (dx, dy) of the other view.
+  bool offset(const FractalFrame& other, int& dx, int& dy) const;
+
+  /// Reads the counts from a file written by write, the file is mapped
+  /// into memory. Returns false if the file does not fit this frame,
+  /// its fractal, view, depth and size must be the same, or if it has
+  /// counts outside not_calculated and the depth.
+  bool read(const QString& file);
+
+  /// If this frame only differs from the other frame by a higher depth,
+  /// and the other frame is resumable and calculated, copies the counts
+  /// of the steps that diverged, and shares the orbits, so the other
+  /// steps continue at the depth of the other frame. Each step that 
+  /// reached the depth of the other frame must have one orbit.
+  /// The orbits of the other frame are not changed, this frame keeps
+  /// its own orbits if it is resumable.
+  /// Returns true if this frame resumes the other frame.
+  bool resume(const FractalFrame& other);
+
+  /// Saves the fractal, view, depth and size, the counts, and the orbits
+  /// if resumable, to a file in native format (see README).
+  /// The orbits of a frame resumed are not saved, steps that continue
+  /// them are calculated again when the file is opened.
+  /// Returns false for a compressed frame.
+  bool save(const QString& file) const;
+
+  /// Sets count of the step at pixel p.
+  void setCount(const QPoint& p, int n) {counts()[index(p)] = n;};
+
+  /// Sets whether the orbits are kept, only for a frame 
+  /// that is not yet calculated.
+  void setResumable(bool resumable);
+
+  /// Returns number of steps.
+  int steps() const {
+    return m_mappedCounts != nullptr ? m_mappedSteps: m_counts.size();};
+
+  /// Gets size of the image.
+  const auto & size() const {return m_size;};
+
+  /// Gets the number of iterations done for the orbits of the frame
+  /// resumed, 0 if this frame does not resume one.
+  auto start() const {return m_start;};
+
+  /// Gets the stats of the steps calculated for this frame,
+  /// they are kept with the counts.
+  const auto & stats() const {return m_stats;};
+
+  /// If this frame is a translation of the other frame at the same
+  /// scale, moves the view to the nearest whole number of steps from
+  /// the other view, and copies the counts of the steps that overlap,
+  /// and the stats if all steps overlap.
+  /// The view moves at most half a step.
+  /// Returns true if this frame was moved.
+  bool translate(const FractalFrame& other);
+
+  /// Gets width of the view.
+  auto width() const {return m_width;};
+
+  /// Writes the fractal, view, depth and size, and the counts 
+  /// run length encoded, to a file.
+  bool write(const QString& file) const;
+private:
+  // The orbits of the steps that reached the depth, the step index,
+  // and the real and imag part in a scalar of 4, 8 or 16 bytes.
+  // The orbits of an opened file are used in place instead of the 
+  // vectors, the file keeps them mapped.
+  struct Orbits
+  {
+    size_t memory() const {
+      return m_steps.capacity() * sizeof(qint32) + m_values.capacity();};
+    size_t size() const {
+      return m_mappedSteps != nullptr ? m_mappedCount: m_steps.size();};
+    const qint32* steps() const {
+      return m_mappedSteps != nullptr ? m_mappedSteps: m_steps.data();};
+    const char* values() const {
+      return m_mappedValues != nullptr ? m_mappedValues: m_values.data();};
+
+    int m_scalar = 0;
+    std::vector<qint32> m_steps;
+    std::vector<char> m_values;
+    
+    std::shared_ptr<QFile> m_file;
+    const qint32* m_mappedSteps = nullptr;
+    const char* m_mappedValues = nullptr;
+    size_t m_mappedCount = 0;
+  };
+
+  void addOrbit(const QPoint& p, int scalar,
+    const DoubleDouble& zr, const DoubleDouble& zi);
+  int* counts() {
+    return m_mappedCounts != nullptr ? m_mappedCounts: m_counts.data();};
+  const int* counts() const {
+    return m_mappedCounts != nullptr ? m_mappedCounts: m_counts.data();};
+  int index(const QPoint& p) const {
+    return (p.y() / m_inc.height()) * m_columns + p.x() / m_inc.width();};
+  std::shared_ptr<const Orbits> orbits() const;
+  std::string parameters() const;
+  bool read(const QString& file, bool load);
+  bool setParameters(const std::string& text);
+  void stamp(
+    const FractalGeometry& geo,
+    QImage& image,
+    const QPoint& p,
+    const QRect& tile,
+    int n) const;
+
+  std::vector<int> m_counts, m_runs;
+  
+  // the orbits kept by this frame, in the order they are added,
+  // and the orbits of the frame resumed, sorted by step
+  std::shared_ptr<Orbits> m_orbits;
+  std::shared_ptr<const Orbits> m_resumed;
+  int m_start = 0;
+
+  // an opened file, the mapped counts are used
+  // instead of the vector, the file keeps them mapped
+  std::shared_ptr<QFile> m_file;
+  int* m_mappedCounts = nullptr;
+  int m_mappedSteps = 0;
+
+  QSize m_inc, m_size;
+  int m_columns = 0;
+  FractalStats m_stats;
+
+  // the parameters the counts were calculated for
+  std::string m_name;
+  double m_diverge = 0;
+  std::complex<double> m_julia;
+  double m_juliaExponent = 0;
+  BigReal m_centerX, m_centerY;
+  double m_width = 0, m_height = 0;
+  int m_depth = 0;
+  bool m_guess = false;
+};
@@ -1,32 +1,46 @@
 ////////////////////////////////////////////////////////////////////////////////
 // Name:      fractalgeometry.cpp
-// Purpose:   Implementation of class FractalControl
+// Purpose:   Implementation of class FractalGeometry
 // Author:    Anton van Wezenbeek
-// Copyright: (c) 2017 Anton van Wezenbeek
+// Copyright: (c) 2017-2026 Anton van Wezenbeek
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include "fractalgeometry.h"
-#include "fractalwidget.h"
 
 FractalGeometry::FractalGeometry(
-  const QwtInterval& xInterval,
-  const QwtInterval& yInterval,
+  const FractalInterval& xInterval,
+  const FractalInterval& yInterval,
   int depth,
   const QString& dir)
-  : m_intervalX(xInterval)
-  , m_intervalY(yInterval)
-  , m_dir(dir)
+  : m_dir(dir)
   , m_coloursMinWave(min_wave)
   , m_coloursMaxWave(max_wave)
   , m_depth(depth)
 {
+  setView(xInterval, yInterval);
+}
+
+FractalInterval FractalGeometry::intervalX() const
+{
+  const double x = m_centerX.toDouble();
+
+  return FractalInterval(x - m_width / 2, x + m_width / 2);
+}
+
+FractalInterval FractalGeometry::intervalY() const
+{
+  const double y = m_centerY.toDouble();
+
+  return FractalInterval(y - m_height / 2, y + m_height / 2);
 }
 
 bool FractalGeometry::isOk() const
 {
   return
-    m_intervalX.isValid() &&
-    m_intervalY.isValid() &&
+    m_width >= 0 &&
+    m_height >= 0 &&
+    m_passes >= 1 &&
   ((!m_useImages && !m_colours.empty()) || (m_useImages && !m_images.empty()));
 }
 
@@ -86,6 +100,58 @@ void FractalGeometry::setColours(int colours)
   m_colours.push_back(qRgb(0, 0, 0));
 }
 
+bool FractalGeometry::setImages(const QStringList& files)
+{
+  m_imagesList = files;
+  
+  if (m_imagesList.isEmpty())
+  {
+    return false;
+  }
+  
+  m_images.clear();
+  m_dir = m_imagesList[0];
+  
+  for (const auto & i : m_imagesList)
+  {
+    // Converted to the format of the rendered image,
+    // so the renderer can copy rows of pixels.
+    const QImage image(QImage(i).convertToFormat(QImage::Format_RGB32));
+    
+    m_images.push_back(
+      (image.width() > m_imagesSize.width() || 
+       image.height() > m_imagesSize.height()) ?
+      image.scaled(m_imagesSize): image);
+  }
+  
+  return true;
+}
+
+void FractalGeometry::setView(
+  const BigReal& x, const BigReal& y, double width, double height)
+{
+  // the center resolves the view size, with guard limbs for the pixels
+  const int limbs = BigReal::limbsFor(std::min(width, height));
+
+  m_centerX = x;
+  m_centerY = y;
+  m_centerX.setLimbs(limbs);
+  m_centerY.setLimbs(limbs);
+  m_width = width;
+  m_height = height;
+}
+
+void FractalGeometry::setView(const FractalInterval& x, const FractalInterval& y)
+{
+  const int limbs = BigReal::limbsFor(std::min(x.width(), y.width()));
+
+  setView(
+    BigReal(x.minValue(), limbs) + BigReal(x.width() / 2, limbs),
+    BigReal(y.minValue(), limbs) + BigReal(y.width() / 2, limbs),
+    x.width(),
+    y.width());
+}
+
 // see
 // http://codingmess.blogspot.com/2009/05/conversion-of-wavelength-in-nanometers.html
 uint FractalGeometry::wav2RGB(double w) const
@@ -145,3 +211,21 @@ uint FractalGeometry::wav2RGB(double w) const
 
   return qRgb(int(SSS*R), int(SSS*G), int(SSS*B));
 }
+
+void FractalGeometry::zoom(double factor)
+{
+  zoom(QRectF(
+    0.5 - factor / 2, 0.5 - factor / 2, factor, factor));
+}
+
+void FractalGeometry::zoom(const QRectF& part)
+{
+  const int limbs = BigReal::limbsFor(std::min(
+    m_width * part.width(), m_height * part.height()));
+
+  setView(
+    m_centerX + BigReal((part.center().x() - 0.5) * m_width, limbs),
+    m_centerY + BigReal(-(part.center().y() - 0.5) * m_height, limbs),
+    m_width * part.width(),
+    m_height * part.height());
+}
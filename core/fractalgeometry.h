@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      fractalgeometry.h
+// Purpose:   Declaration of class FractalGeometry
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2017-2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+#include <QColor>
+#include <QDir>
+#include <QImage>
+#include <QRectF>
+#include <QSize>
+#include "bigreal.h"
+#include "fractalinterval.h"
+
+const int min_wave = 380;
+const int max_wave = 780;
+
+class FractalControl;
+
+/// This class contains general geometry values for a fractal.
+/// The view is kept as a high precision center and a double width
+/// and height, so pixel coordinates can be resolved at any zoom level.
+/// The intervals are double approximations of the view, for the axes.
+class FractalGeometry
+{
+  friend class FractalControl;
+public:
+  /// Default constructor.
+  FractalGeometry(
+    /// using this x interval
+    const FractalInterval& xInterval = FractalInterval(-2,2),
+    /// using this y interval
+    const FractalInterval& yInterval = FractalInterval(-2,2),
+    /// iteration depth
+    int depth = 2,
+    /// dir for images
+    const QString& dir = QString());
+
+  /// Gets real part of the view center.
+  const auto & centerX() const {return m_centerX;};
+
+  /// Gets imag part of the view center.
+  const auto & centerY() const {return m_centerY;};
+
+  /// Returns current colour.
+  const auto & colour() const {return m_colours[m_colourIndex];};
+
+  /// Returns colour.
+  const auto & colour(int i) const {return m_colours[i];};
+
+  /// Returns colour index.
+  auto colourIndex() const {return m_colourIndex;};
+  
+  /// Gets colours.
+  const auto & colours() const {return m_colours;};
+
+  /// Gets iteration depth.
+  auto depth() const {return m_depth;};
+  
+  /// Returns real distance from the center for pixel x
+  /// in an image of width.
+  double deltaX(int x, int width) const {
+    return ((double)x / width - 0.5) * m_width;};
+
+  /// Returns imag distance from the center for pixel y
+  /// in an image of height.
+  double deltaY(int y, int height) const {
+    return -((double)y / height - 0.5) * m_height;};
+
+  /// Gets the dir used when using images instead of colours.
+  const auto & dir() const {return m_dir;};
+
+  /// Returns true if finished setColour.
+  bool finished() const {return m_finished;};
+  
+  /// Gets guess, if true solid areas are guessed, by calculating
+  /// the border of a rectangle only, and filling it if the border
+  /// has one iteration count.
+  auto guess() const {return m_guess;};
+  
+  /// Gets height of the view.
+  auto height() const {return m_height;};
+
+  /// Gets image.
+  const auto & image(int i) const {return m_images[i];};
+  
+  /// Gets images.
+  const auto & images() const {return m_images;};
+  
+  /// Gets the x interval, approximating the view.
+  FractalInterval intervalX() const;
+  
+  /// Gets the y interval, approximating the view.
+  FractalInterval intervalY() const;
+  
+  /// Returns true if parameters are ok.
+  bool isOk() const;
+  
+  /// Gets number of passes, each pass doubles the resolution
+  /// of the previous one, the last pass is at full resolution.
+  auto passes() const {return m_passes;};
+  
+  /// Prepares colour index to be used from start or from end.  
+  void prepare(bool from_start) {
+    m_colourIndex = (from_start ? 0: m_colours.size() - 1);
+    m_colourIndexFromStart = from_start;};
+
+  /// Sets colour(s).
+  bool setColour(const QColor& color);
+
+  /// Sets colours.
+  void setColours(int size);
+
+  /// Sets iteration depth.
+  void setDepth(int depth) {m_depth = depth;};
+
+  /// Sets guess, see guess.
+  void setGuess(bool guess) {m_guess = guess;};
+
+  /// Sets images from files, these are converted to the format
+  /// of the rendered image and scaled down to the images size.
+  /// Returns false if there are no files.
+  bool setImages(const QStringList& files);
+
+  /// Sets number of passes, see passes.
+  void setPasses(int passes) {m_passes = passes;};
+
+  /// Sets use images, see setImages.
+  void setUseImages(bool use) {m_useImages = use;};
+
+  /// Sets the view.
+  void setView(
+    /// real part of center
+    const BigReal& x,
+    /// imag part of center
+    const BigReal& y,
+    /// width
+    double width,
+    /// height
+    double height);
+
+  /// Sets the view from intervals.
+  void setView(const FractalInterval& x, const FractalInterval& y);
+
+  /// Gets use images.
+  bool useImages() const {return m_useImages;};
+
+  /// Gets width of the view.
+  auto width() const {return m_width;};
+
+  /// Zooms the view, keeping the center.
+  void zoom(double factor);
+
+  /// Zooms into part of the view, as fractions of the view,
+  /// (0,0) being the top left and (1,1) the bottom right.
+  void zoom(const QRectF& part);
+private:
+  uint wav2RGB(double wave) const;
+
+  BigReal m_centerX;
+  BigReal m_centerY;
+
+  double m_width;
+  double m_height;
+
+  QDir m_dir;
+  QSize m_imagesSize = QSize(32, 32);
+  QStringList m_imagesList;
+
+  double m_coloursMinWave;  
+  double m_coloursMaxWave;  
+  
+  int m_colourIndex = 0;
+  int m_depth;
+  int m_passes = 3;
+  
+  bool m_colourIndexFromStart = true;
+  bool m_finished = false;
+  bool m_guess = false;
+  // use images instead of colours for rendering
+  bool m_useImages = false;
+  
+  // the last colour is used for converge
+  std::vector<uint> m_colours;
+  
+  // the last image is used for convergence
+  std::vector<QImage> m_images;
+};
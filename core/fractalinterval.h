@@ -0,0 +1,44 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      fractalinterval.h
+// Purpose:   Declaration of class FractalInterval
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/// This class offers an interval of real values, as shown on an axis.
+/// It has the interface of QwtInterval, and converts from it, 
+/// so the core does not depend on Qwt.
+class FractalInterval
+{
+public:
+  /// Default constructor, an invalid interval.
+  FractalInterval() {;};
+
+  /// Constructor.
+  FractalInterval(double min, double max)
+    : m_min(min)
+    , m_max(max) {;};
+
+  /// Constructor from an interval offering minValue and maxValue,
+  /// like QwtInterval.
+  template <typename T>
+  FractalInterval(const T& other)
+    : m_min(other.minValue())
+    , m_max(other.maxValue()) {;};
+
+  /// Returns true if min is not above max.
+  bool isValid() const {return m_min <= m_max;};
+
+  /// Gets max value.
+  auto maxValue() const {return m_max;};
+
+  /// Gets min value.
+  auto minValue() const {return m_min;};
+
+  /// Returns width.
+  auto width() const {return m_max - m_min;};
+private:
+  double m_min = 0, m_max = -1;
+};
@@ -0,0 +1,1091 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      fractalrenderer.cpp
+// Purpose:   Implementation of class FractalRenderer
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2017-2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <QFile>
+#include "fractalrenderer.h"
+#include "doubledouble.h"
+#include "fractal.h"
+
+// Size in pixels of the tiles handed out to the render pool.
+const int tile_size = 64;
+
+// Number of tiles for each thread in a batch of tiles, 
+// checkpoints are written between batches.
+const int checkpoint_batch = 4;
+
+// Rectangles with a side of at most this number of steps
+// are not split when guessing.
+const int guess_min = 4;
+
+// Converts a coordinate to the scalar type of a kernel.
+template <typename T>
+static T toScalar(const BigReal& value)
+{
+  return T(value.toDouble());
+}
+
+template <>
+DoubleDouble toScalar<DoubleDouble>(const BigReal& value)
+{
+  const double hi = value.toDouble();
+  
+  return DoubleDouble(hi, (value - BigReal(hi, value.limbs())).toDouble());
+}
+
+// Converts an orbit to the scalar type of a kernel, float and double
+// orbits are kept exactly in the high part (see FractalFrame::orbit).
+template <typename T>
+static T fromOrbit(const DoubleDouble& value)
+{
+  return T(value.hi());
+}
+
+template <>
+DoubleDouble fromOrbit<DoubleDouble>(const DoubleDouble& value)
+{
+  return value;
+}
+
+FractalRenderer::FractalRenderer(QObject *parent)
+  : QThread(parent)
+{
+}
+
+FractalRenderer::~FractalRenderer()
+{
+  stop();
+}
+
+template <typename T>
+bool FractalRenderer::calcPoints(
+  const Fractal& fractal,
+  FractalKernel<T> kernel,
+  const FractalGeometry& geo,
+  const QSize& size,
+  const std::vector<QPoint>& points)
+{
+  if (points.empty())
+  {
+    return true;
+  }
+  
+  // The points are calculated at once, so the SIMD
+  // kernels can iterate several points at the same time.
+  const int count = points.size();
+  std::vector<T> cx(count);
+  std::vector<T> cy(count);
+  std::vector<int> n(count);
+  std::vector<T> zr, zi;
+
+  const T centerX(toScalar<T>(geo.centerX()));
+  const T centerY(toScalar<T>(geo.centerY()));
+
+  for (int i = 0; i < count; i++) 
+  {
+    // The center and a delta, so each coordinate is rounded once.
+    cx[i] = centerX + T(geo.deltaX(points[i].x(), size.width()));
+    cy[i] = centerY + T(geo.deltaY(points[i].y(), size.height()));
+  }
+  
+  // The orbits are copied, so an interrupted kernel leaves
+  // the orbits of the frame as they were. Steps of a frame that
+  // resumes another one start at the orbits of the other frame.
+  FractalOrbits<T> orbits{nullptr, nullptr, m_frame.start()};
+  
+  if (m_frame.isResumable() || orbits.m_start > 0)
+  {
+    zr.resize(count);
+    zi.resize(count);
+    
+    for (int i = 0; i < count && orbits.m_start > 0; i++) 
+    {
+      DoubleDouble r, im;
+      m_frame.orbit(points[i], r, im);
+      zr[i] = fromOrbit<T>(r);
+      zi[i] = fromOrbit<T>(im);
+    }
+    
+    orbits.m_zr = zr.data();
+    orbits.m_zi = zi.data();
+  }
+    
+  if (interrupted() || 
+    !kernel(fractal, cx.data(), cy.data(), n.data(), count, geo.depth(),
+      orbits.m_zr != nullptr ? &orbits: nullptr))
+  {
+    return false;
+  }
+
+  for (int i = 0; i < count; i++) 
+  {
+    m_frame.setCount(points[i], n[i]);
+  }
+  
+  // Only the orbits of steps that reached the depth are kept,
+  // the tiles add them one at a time.
+  if (m_frame.isResumable())
+  {
+    QMutexLocker locker(&m_orbitsMutex);
+    
+    for (int i = 0; i < count; i++) 
+    {
+      if (n[i] == geo.depth())
+      {
+        m_frame.addOrbit(points[i], zr[i], zi[i]);
+      }
+    }
+  }
+
+  return true;
+}
+
+bool FractalRenderer::calcPointsPerturbation(
+  const Perturbation& perturbation,
+  const FractalGeometry& geo,
+  const QSize& size,
+  const std::vector<QPoint>& points)
+{
+  if (points.empty())
+  {
+    return true;
+  }
+  
+  const int count = points.size();
+  std::vector<std::complex<double>> c(count);
+  std::vector<int> n(count);
+
+  for (int i = 0; i < count; i++) 
+  {
+    // Deltas from the reference point at the center of the view.
+    c[i] = std::complex<double>(
+      geo.deltaX(points[i].x(), size.width()), 
+      geo.deltaY(points[i].y(), size.height()));
+  }
+
+  if (!perturbation.calc(c.data(), n.data(), count, 
+    [this]() {return interrupted();}))
+  {
+    return false;
+  }
+
+  for (int i = 0; i < count; i++) 
+  {
+    m_frame.setCount(points[i], n[i]);
+  }
+
+  return true;
+}
+
+const QSize FractalRenderer::calcStep(const FractalGeometry& geo) const
+{
+  if (geo.useImages())
+  {
+    return QSize(geo.images().front().width(), geo.images().front().height());
+  }
+  
+  return QSize(1, 1);
+}
+
+const std::vector<QRect> FractalRenderer::calcTiles(
+  const QSize& size, const QSize& inc) const
+{
+  // A tile is a multiple of the step, so each step is inside one tile.
+  const int tw = std::max(1, tile_size / inc.width()) * inc.width();
+  const int th = std::max(1, tile_size / inc.height()) * inc.height();
+
+  std::vector<QRect> tiles;
+
+  for (int y = 0; y < size.height(); y += th)
+  {
+    for (int x = 0; x < size.width(); x += tw)
+    {
+      tiles.push_back(QRect(x, y, 
+        std::min(tw, size.width() - x), 
+        std::min(th, size.height() - y)));
+    }
+  }
+
+  return tiles;
+}
+
+void FractalRenderer::cont()
+{
+  QMutexLocker locker(&m_mutex);
+  
+  if (m_state == RENDERING_PAUSED || m_state == RENDERING_INTERRUPT)
+  {
+    setState(m_oldState);
+    m_condition.wakeOne();
+  }
+}
+
+double FractalRenderer::guessed() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_guessed;
+}
+
+bool FractalRenderer::guessTile(
+  const QRect& tile, 
+  const QSize& inc, 
+  const QRect& rect,
+  const Calc& calc,
+  const Fractal& fractal)
+{
+  const auto pos = [&](int i, int j) {
+    return QPoint(
+      tile.left() + i * inc.width(), tile.top() + j * inc.height());};
+  
+  // Calculate the border of the rectangle.
+  std::vector<QPoint> points;
+  
+  for (int i = rect.left(); i <= rect.right(); i++)
+  {
+    for (int j = rect.top(); j <= rect.bottom(); 
+      j += (i == rect.left() || i == rect.right() ? 1: 
+        std::max(1, rect.height() - 1)))
+    {
+      if (m_frame.count(pos(i, j)) < 0)
+      {
+        points.push_back(pos(i, j));
+      }
+    }
+  }
+  
+  if (!calc(points))
+  {
+    return false;
+  }
+  
+  if (rect.width() <= 2 || rect.height() <= 2)
+  {
+    return true;
+  }
+  
+  const QRect inside(rect.adjusted(1, 1, -1, -1));
+  const int n = m_frame.count(pos(rect.left(), rect.top()));
+  bool uniform = true;
+  
+  for (int i = rect.left(); i <= rect.right() && uniform; i++)
+  {
+    for (int j = rect.top(); j <= rect.bottom() && uniform; 
+      j += (i == rect.left() || i == rect.right() ? 1: rect.height() - 1))
+    {
+      uniform = (m_frame.count(pos(i, j)) == n);
+    }
+  }
+  
+  // As a guard the center is calculated as well, and steps inside
+  // calculated by previous passes must agree with the border.
+  if (uniform)
+  {
+    const QPoint center(pos(
+      (rect.left() + rect.right()) / 2, (rect.top() + rect.bottom()) / 2));
+    
+    if (m_frame.count(center) < 0 &&
+      !calc(std::vector<QPoint>{center}))
+    {
+      return false;
+    }
+    
+    std::vector<QPoint> fill;
+    
+    for (int j = inside.top(); j <= inside.bottom() && uniform; j++)
+    {
+      for (int i = inside.left(); i <= inside.right() && uniform; i++)
+      {
+        const int count = m_frame.count(pos(i, j));
+        
+        if (count < 0)
+        {
+          fill.push_back(pos(i, j));
+        }
+        else 
+        {
+          uniform = (count == n);
+        }
+      }
+    }
+    
+    if (uniform)
+    {
+      for (const auto& p : fill)
+      {
+        m_frame.setCount(p, n);
+      }
+      
+      fractal.stats().add(FractalStats::SHORTCUT_GUESS, fill.size());
+      
+      return true;
+    }
+  }
+  
+  // Small rectangles are calculated, others are split in four, 
+  // sharing their borders.
+  if (rect.width() <= guess_min || rect.height() <= guess_min)
+  {
+    for (int j = inside.top(); j <= inside.bottom(); j++)
+    {
+      points.clear();
+      
+      for (int i = inside.left(); i <= inside.right(); i++)
+      {
+        if (m_frame.count(pos(i, j)) < 0)
+        {
+          points.push_back(pos(i, j));
+        }
+      }
+      
+      if (!calc(points))
+      {
+        return false;
+      }
+    }
+    
+    return true;
+  }
+  
+  const int x = (rect.left() + rect.right()) / 2;
+  const int y = (rect.top() + rect.bottom()) / 2;
+  
+  return 
+    guessTile(tile, inc, QRect(QPoint(rect.left(), rect.top()), QPoint(x, y)), 
+      calc, fractal) &&
+    guessTile(tile, inc, QRect(QPoint(x, rect.top()), QPoint(rect.right(), y)), 
+      calc, fractal) &&
+    guessTile(tile, inc, QRect(QPoint(rect.left(), y), QPoint(x, rect.bottom())), 
+      calc, fractal) &&
+    guessTile(tile, inc, QRect(QPoint(x, y), QPoint(rect.right(), rect.bottom())), 
+      calc, fractal);
+}
+
+QImage FractalRenderer::image()
+{
+  // The ready buffer becomes the front buffer, if one was published.
+  QMutexLocker locker(&m_buffersMutex);
+  
+  if (m_published)
+  {
+    std::swap(m_front, m_ready);
+    m_published = false;
+  }
+  
+  return m_buffers[m_front];
+}
+
+void FractalRenderer::interrupt()
+{
+  QMutexLocker locker(&m_mutex);
+  
+  if (m_state == RENDERING_ACTIVE)
+  {
+    m_oldState = m_state;
+    setState(RENDERING_INTERRUPT);
+    m_condition.wakeOne();
+  }
+}
+
+bool FractalRenderer::nextStateForCalcEnd()
+{
+  QMutexLocker locker(&m_mutex);
+
+  switch (m_state)
+  {
+  case RENDERING_INTERRUPT:
+  case RENDERING_PAUSED:
+    m_condition.wait(&m_mutex);
+    break;
+  }
+  
+  // A refresh while paused.
+  if (m_snapshot.exchange(false))
+  {
+    snapshot();
+  }
+  
+  return m_state != RENDERING_STOPPED;
+}
+    
+void FractalRenderer::pause()
+{
+  QMutexLocker locker(&m_mutex);
+  
+  if (m_state != RENDERING_PAUSED)
+  {
+    m_oldState = m_state;
+    setState(RENDERING_PAUSED);
+    m_condition.wakeOne();
+  }
+}
+
+void FractalRenderer::publish(int state)
+{
+  // An image of a superseded request is not shown.
+  if (back().isNull() || superseded())
+  {
+    return;
+  }
+  
+  // The back buffer becomes the ready buffer, the image is not copied.
+  {
+    QMutexLocker locker(&m_buffersMutex);
+    std::swap(m_back, m_ready);
+    m_published = true;
+  }
+  
+  // This image serves a pending refresh as well.
+  m_snapshot = false;
+  
+  emit rendered(state, m_rendering);
+}
+
+void FractalRenderer::refresh()
+{
+  QMutexLocker locker(&m_mutex);
+  m_snapshot = true;
+  m_condition.wakeOne();
+}
+
+bool FractalRenderer::render(
+  const Fractal& fractal,
+  const QSize& size,
+  const FractalGeometry& geometry)
+{
+  if (!fractal.isOk() || !geometry.isOk())
+  {
+    return false;
+  }
+
+  QMutexLocker locker(&m_mutex);
+  
+  m_generation++;
+  m_requested.start();
+  setState(RENDERING_START);
+  m_size = size;
+  m_fractal = fractal;
+  m_geo = geometry;
+  m_fractal.setRenderer(this);
+  m_condition.wakeOne();
+    
+  return true;
+}
+
+bool FractalRenderer::renderTile(
+  const QRect& tile, 
+  const QSize& inc, 
+  int block,
+  const Calc& calc,
+  const Fractal& fractal,
+  const FractalGeometry& geo,
+  const QSize& size)
+{
+  // The tile is calculated at once, calling the kernel once.
+  std::vector<QPoint> points;
+  const int bw = block * inc.width();
+  const int bh = block * inc.height();
+  
+  for (int y = tile.top(); y <= tile.bottom(); y+= bh)
+  {
+    for (int x = tile.left(); x <= tile.right(); x += bw)
+    {
+      if (m_frame.count(QPoint(x, y)) < 0)
+      {
+        points.push_back(QPoint(x, y));
+      }
+    }
+  }
+  
+  const int columns = (tile.width() + bw - 1) / bw;
+  const int rows = (tile.height() + bh - 1) / bh;
+  
+  // A tile without any step calculated is a grid, the fractal calculates
+  // it without a coordinate per step, unless orbits are kept or
+  // continued, or the view needs perturbation.
+  if (points.empty() || int(points.size()) != columns * rows || 
+    m_frame.isResumable() || m_frame.start() > 0 ||
+    m_precision == PRECISION_PERTURBATION)
+  {
+    return calc(points);
+  }
+  
+  // The tile uses the precision of the frame, and the distances
+  // of calcPoints, so it gives the same counts.
+  FractalTile grid{
+    toScalar<DoubleDouble>(geo.centerX()),
+    toScalar<DoubleDouble>(geo.centerY()),
+    std::vector<double>(columns),
+    std::vector<double>(rows),
+    m_precision,
+    geo.depth()};
+  
+  for (int i = 0; i < columns; i++)
+  {
+    grid.m_deltaX[i] = geo.deltaX(tile.left() + i * bw, size.width());
+  }
+  
+  for (int j = 0; j < rows; j++)
+  {
+    grid.m_deltaY[j] = geo.deltaY(tile.top() + j * bh, size.height());
+  }
+  
+  std::vector<int> n(points.size());
+  
+  if (interrupted() || !fractal.calc(grid, n.data()))
+  {
+    return false;
+  }
+  
+  for (size_t i = 0; i < points.size(); i++)
+  {
+    m_frame.setCount(points[i], n[i]);
+  }
+  
+  return true;
+}
+
+bool FractalRenderer::renderTiles(
+  const Fractal& fractal,
+  const FractalGeometry& geometry,
+  const QSize& size)
+{
+  FractalGeometry geo(geometry);
+  
+  if (size.isEmpty() || fractal.kernel() == nullptr ||
+    (geo.useImages() ? geo.images().empty(): geo.colours().empty()))
+  {
+    return true;
+  }
+
+  const QSize inc = calcStep(geo);
+  const std::vector<QRect> tiles(calcTiles(size, inc));
+  
+  QString checkpoint;
+  int interval = 0;
+  bool keepOrbits = false;
+  FractalFrame opened;
+  
+  {
+    QMutexLocker locker(&m_mutex);
+    checkpoint = m_checkpoint;
+    interval = m_checkpointInterval;
+    keepOrbits = m_keepOrbits;
+    opened = m_opened;
+  }
+  
+  // The counts of the last image are used again if only the colours
+  // or images changed.
+  if (!m_frame.matches(fractal, geo, size, inc))
+  {
+    FractalFrame frame(fractal, geo, size, inc);
+    bool checkpointed = false;
+    
+    // An opened frame is used as it is, a recently rendered view is 
+    // taken from the cache, a higher depth of the opened frame or the 
+    // last image only continues the steps that did not diverge, and
+    // a pan of the last image only calculates the steps exposed,
+    // the view is moved to whole steps for that.
+    if (opened.matches(fractal, geo, size, inc))
+    {
+      frame = opened;
+      
+      // The frame shares the counts of the opened frame, they change 
+      // when steps are calculated, so the opened frame is used once.
+      QMutexLocker locker(&m_mutex);
+      
+      if (m_opened.key() == opened.key())
+      {
+        m_opened = FractalFrame();
+      }
+    }
+    else if (m_cache.find(frame))
+    {
+      geo.setView(
+        frame.centerX(), frame.centerY(), frame.width(), frame.height());
+    }
+    else if (!checkpoint.isEmpty() && frame.read(checkpoint))
+    {
+      checkpointed = true;
+    }
+    else if (frame.resume(opened) || frame.resume(m_frame))
+    {
+      frame.setResumable(keepOrbits);
+    }
+    else if (frame.translate(m_frame))
+    {
+      geo.setView(
+        frame.centerX(), frame.centerY(), frame.width(), frame.height());
+    }
+    else
+    {
+      // Guessed steps have no orbits.
+      frame.setResumable(keepOrbits && !geo.guess());
+    }
+    
+    m_frame = std::move(frame);
+    
+    // A checkpoint of another image, e.g. one that was superseded,
+    // is removed, so it is not continued after a restart.
+    if (!checkpointed && !checkpoint.isEmpty())
+    {
+      QFile::remove(checkpoint);
+    }
+  }
+  
+  // The precision is resolved once for the frame, the cheapest one
+  // that resolves the pixels.
+  const double magnitude = std::max(
+    std::fabs(geo.centerX().toDouble()) + geo.width() / 2, 
+    std::fabs(geo.centerY().toDouble()) + geo.height() / 2);
+  const double spacing = std::min(
+    geo.width() / size.width(), 
+    geo.height() / size.height());
+  const FractalPrecision precision = fractal.precision(magnitude, spacing);
+  
+  m_precision = precision;
+  
+  // Perturbation does not keep the orbits.
+  if (precision == PRECISION_PERTURBATION && m_frame.isResumable())
+  {
+    m_frame.setResumable(false);
+  }
+  
+  // Perturbation uses the center of the view as reference.
+  std::unique_ptr<Perturbation> perturbation;
+  
+  if (precision == PRECISION_PERTURBATION)
+  {
+    const int limbs = std::max(
+      BigReal::limbsFor(spacing), geo.centerX().limbs());
+    
+    BigReal x(geo.centerX());
+    BigReal y(geo.centerY());
+    x.setLimbs(limbs);
+    y.setLimbs(limbs);
+    
+    perturbation = std::make_unique<Perturbation>(fractal, x, y, geo.depth());
+  }
+  
+  const Calc calc = [&](const std::vector<QPoint>& points) {
+    switch (precision)
+    {
+      case PRECISION_FLOAT: return calcPoints(
+        fractal, fractal.kernelFloat(), geo, size, points);
+      case PRECISION_DOUBLE: return calcPoints(
+        fractal, fractal.kernel(), geo, size, points);
+      case PRECISION_DOUBLE_DOUBLE: return calcPoints(
+        fractal, fractal.kernelDoubleDouble(), geo, size, points);
+      default: return calcPointsPerturbation(
+        *perturbation, geo, size, points);
+    }};
+  
+  // The last pass guesses solid areas if asked for, the coarse
+  // passes are too sparse for it.
+  const auto renderTile = [&](const QRect& tile, int block) {
+    if (!(block == 1 && geo.guess() ? 
+      guessTile(tile, inc, QRect(0, 0, 
+        (tile.width() + inc.width() - 1) / inc.width(), 
+        (tile.height() + inc.height() - 1) / inc.height()), calc, fractal):
+      this->renderTile(tile, inc, block, calc, fractal, geo, size)))
+    {
+      return false;
+    }
+    
+    m_frame.colour(geo, back(), tile, block);
+    
+    return true;};
+  
+  QElapsedTimer checkpointTimer;
+  checkpointTimer.start();
+  
+  // The frame is written between batches of tiles, while no tile 
+  // is calculated, so the counts written are consistent.
+  const auto writeCheckpoint = [&]() {
+    if (!checkpoint.isEmpty() && !superseded())
+    {
+      m_frame.write(checkpoint);
+    }
+    
+    checkpointTimer.restart();};
+  
+  const auto calculated = [&](int block) {
+    return std::all_of(tiles.begin(), tiles.end(), 
+      [&](const QRect& tile) {return m_frame.isCalculated(tile, block);});};
+  
+  // Each pass halves the block size of the previous one, and only
+  // calculates the steps that the previous passes did not.
+  // Passes that are already calculated are skipped.
+  int pass = 0;
+  
+  while (pass < geo.passes() - 1 && 
+    calculated(1 << (geo.passes() - 2 - pass)))
+  {
+    pass++;
+  }
+  
+  for (; pass < geo.passes(); pass++)
+  {
+    const int block = 1 << (geo.passes() - 1 - pass);
+    
+    // A buffer is only allocated when it is first written at a size,
+    // so a single pass image uses one buffer.
+    if (back().size() != size)
+    {
+      QMutexLocker locker(&m_buffersMutex);
+      back() = QImage(size, QImage::Format_RGB32);
+    }
+    
+    // Tiles write concurrently into the image, so it must not be shared.
+    back().bits();
+
+    // Tiles that are interrupted are rendered again when continuing.
+    std::vector<char> done(tiles.size(), false);
+    
+    // Tiles already calculated only need the colour pass.
+    m_pool.run(tiles.size(),
+      [&](int i) {
+        if (m_frame.isCalculated(tiles[i], block))
+        {
+          m_frame.colour(geo, back(), tiles[i], block);
+          done[i] = true;
+        }});
+
+    
+    forever
+    {
+      std::vector<int> todo;
+      
+      for (int i = 0; i < (int)tiles.size(); i++)
+      {
+        if (!done[i])
+        {
+          todo.push_back(i);
+        }
+      }
+      
+      if (todo.empty())
+      {
+        break;
+      }
+      
+      if (perturbation != nullptr && !perturbation->isReady() &&
+        !perturbation->reference([this]() {return interrupted();}))
+      {
+        if (superseded())
+        {
+          return true;
+        }
+        
+        if (!nextStateForCalcEnd())
+        {
+          return false;
+        }
+        
+        continue;
+      }
+      
+      // Without checkpoints each interval, all tiles are one batch.
+      const int batch = (checkpoint.isEmpty() || interval <= 0 ? 
+        todo.size(): checkpoint_batch * m_pool.threads());
+      
+      for (int first = 0; first < (int)todo.size() && !interrupted(); 
+        first += batch)
+      {
+        const int finished = tiles.size() - todo.size() + first;
+        
+        m_pool.run(std::min(batch, (int)todo.size() - first), 
+          [&](int i) {
+            if (renderTile(tiles[todo[first + i]], block))
+            {
+              done[todo[first + i]] = true;
+            }},
+          [&](int tasks) {
+            emit rendering(
+              (finished + tasks) * size.height() / tiles.size(), 
+              size.height());
+            
+            // A refresh is served while the other tiles continue.
+            if (m_snapshot.exchange(false))
+            {
+              snapshot();
+            }});
+        
+        if (interval > 0 && checkpointTimer.elapsed() >= 1000 * interval)
+        {
+          writeCheckpoint();
+        }
+      }
+      
+      if (std::count(done.begin(), done.end(), true) == (int)tiles.size())
+      {
+        break;
+      }
+      
+      // A newer request is rendered instead, the steps calculated
+      // so far stay in the frame.
+      if (superseded())
+      {
+        return true;
+      }
+      
+      // Interrupted, paused or stopped.
+      writeCheckpoint();
+      
+      if (!nextStateForCalcEnd())
+      {
+        return false;
+      }
+    }
+    
+    // A preview of the whole image at the end of each pass,
+    // except the last one, that is emitted by run.
+    if (pass < geo.passes() - 1)
+    {
+      publish(RENDERING_ACTIVE);
+    }
+  }
+  
+  // Images larger than a step reach into the tiles right and below,
+  // tiles coloured before the tiles left and above them were calculated
+  // are coloured again (see FractalFrame::colour).
+  if (geo.useImages() && std::any_of(
+    geo.images().begin(), geo.images().end(), [&](const QImage& image) {
+      return image.width() > inc.width() || image.height() > inc.height();}))
+  {
+    m_pool.run(tiles.size(),
+      [&](int i) {m_frame.colour(geo, back(), tiles[i]);});
+  }
+  
+  m_cache.insert(m_frame);
+  
+  // The image is finished, so is its checkpoint.
+  if (!checkpoint.isEmpty())
+  {
+    QFile::remove(checkpoint);
+  }
+  
+  return true;
+}
+
+void FractalRenderer::restart()
+{
+  QMutexLocker locker(&m_mutex);
+  setState(RENDERING_START);
+  m_condition.wakeOne();
+}
+
+void FractalRenderer::run()
+{
+  forever
+  {
+    m_mutex.lock();
+    
+    // Requests that follow each other within the debounce time 
+    // are coalesced, only the last one is rendered.
+    while (
+      m_state == RENDERING_START && 
+      m_requested.isValid() && 
+      m_requested.elapsed() < m_debounce)
+    {
+      m_condition.wait(&m_mutex, m_debounce - m_requested.elapsed());
+    }
+    
+    if (m_state == RENDERING_STOPPED)
+    {
+      m_mutex.unlock();
+      return;
+    }
+    
+    m_rendering = m_generation;
+    setState(RENDERING_ACTIVE);
+    const QSize size(m_size);
+    const FractalGeometry geo(m_geo);
+    const Fractal fractal(m_fractal);
+    fractal.stats().reset();
+    
+    if (m_threadsChanged)
+    {
+      m_pool.setThreads(m_threads);
+      m_threadsChanged = false;
+    }
+    
+    if (m_cacheSize != m_cache.size())
+    {
+      m_cache.setSize(m_cacheSize);
+    }
+    
+    if (m_cacheDir != m_cache.dir() || m_cacheDisk != m_cache.disk())
+    {
+      m_cache.setDisk(m_cacheDir, m_cacheDisk);
+    }
+    
+    m_mutex.unlock();
+    
+    if (!renderTiles(fractal, geo, size))
+    {
+      return;
+    }
+
+    m_mutex.lock();
+    
+    // The stats are kept with the frame, so counts that are used
+    // again, e.g. from the cache, report the stats they were
+    // calculated with.
+    m_frame.addStats(fractal.stats());
+    m_stats = m_frame.stats();
+    m_guessed = (m_frame.steps() > 0 ? 
+      (double)m_stats.count(FractalStats::SHORTCUT_GUESS) / m_frame.steps(): 0);
+
+    if (!interrupted())
+    {
+      setState(RENDERING_READY);
+    }
+
+    publish(m_state);
+
+    switch (m_state)
+    {
+      case RENDERING_INTERRUPT:
+      case RENDERING_PAUSED:
+      case RENDERING_READY:
+        m_condition.wait(&m_mutex);
+        break;
+      case RENDERING_STOPPED:
+        m_mutex.unlock();
+        return;
+      case RENDERING_START:
+        // A superseded request leaves the state at start, so the next
+        // request is debounced as well.
+        break;
+      default: 
+        setState(RENDERING_ACTIVE);
+        break;
+    }
+        
+    m_mutex.unlock();
+  }
+}
+
+bool FractalRenderer::saveFrame(const QString& file)
+{
+  // The frame only changes after a next request leaves the ready state,
+  // so it is copied holding the mutex, and written without it.
+  FractalFrame frame;
+
+  {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_state != RENDERING_READY)
+    {
+      return false;
+    }
+
+    frame = m_frame;
+  }
+
+  return frame.save(file);
+}
+
+void FractalRenderer::setCacheDisk(const QString& dir, size_t size)
+{
+  QMutexLocker locker(&m_mutex);
+  m_cacheDir = dir;
+  m_cacheDisk = size;
+}
+
+void FractalRenderer::setCacheSize(size_t size)
+{
+  QMutexLocker locker(&m_mutex);
+  m_cacheSize = size;
+}
+
+void FractalRenderer::setCheckpoint(const QString& file, int seconds)
+{
+  QMutexLocker locker(&m_mutex);
+  m_checkpoint = file;
+  m_checkpointInterval = seconds;
+}
+
+void FractalRenderer::setDebounce(int ms)
+{
+  QMutexLocker locker(&m_mutex);
+  m_debounce = ms;
+}
+
+void FractalRenderer::setFrame(const FractalFrame& frame)
+{
+  QMutexLocker locker(&m_mutex);
+  m_opened = frame;
+}
+
+void FractalRenderer::setKeepOrbits(bool keep)
+{
+  QMutexLocker locker(&m_mutex);
+  m_keepOrbits = keep;
+}
+
+void FractalRenderer::setState(int state)
+{
+  // The token is set for the states that interrupt, and when 
+  // the request being rendered is superseded.
+  m_state = state;
+  m_cancel.store(
+    state == RENDERING_PAUSED || 
+    state == RENDERING_INTERRUPT || 
+    state == RENDERING_STOPPED ||
+    superseded(), std::memory_order_relaxed);
+}
+
+void FractalRenderer::setThreads(int threads)
+{
+  QMutexLocker locker(&m_mutex);
+  m_threads = threads;
+  m_threadsChanged = true;
+}
+
+void FractalRenderer::snapshot()
+{
+  // The back buffer is copied into the ready buffer, the tiles 
+  // being rendered show up in the next image.
+  {
+    QMutexLocker locker(&m_buffersMutex);
+    
+    if (back().isNull() || superseded())
+    {
+      return;
+    }
+    
+    if (m_buffers[m_ready].size() != back().size())
+    {
+      m_buffers[m_ready] = QImage(back().size(), back().format());
+    }
+    
+    std::copy_n(back().constBits(), back().sizeInBytes(), 
+      m_buffers[m_ready].bits());
+    m_published = true;
+  }
+  
+  emit rendered(RENDERING_SNAPSHOT, m_rendering);
+}
+
+FractalStats FractalRenderer::stats() const
+{
+  QMutexLocker locker(&m_mutex);
+  return m_stats;
+}
+
+void FractalRenderer::stop()
+{
+  m_mutex.lock();
+  setState(RENDERING_STOPPED);
+  m_condition.wakeOne();
+  m_mutex.unlock();
+
+  wait();
+}
@@ -0,0 +1,334 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      fractalrenderer.h
+// Purpose:   Declaration of class FractalRenderer
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2017-2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QMutex>
+#include <QPoint>
+#include <QRect>
+#include <QThread>
+#include <QWaitCondition>
+#include "fractal.h"
+#include "fractalcache.h"
+#include "fractalframe.h"
+#include "fractalgeometry.h"
+#include "perturbation.h"
+#include "renderpool.h"
+
+enum RenderingState
+{
+  RENDERING_INIT,      /// INIT state
+  RENDERING_READY,     /// READY state
+  RENDERING_ACTIVE,    /// ACTIVE state
+  RENDERING_INTERRUPT, /// INTERRUPT state
+  RENDERING_PAUSED,    /// PAUSED state
+  RENDERING_STOPPED,   /// STOPPED state
+  RENDERING_START,     /// START state
+  RENDERING_SNAPSHOT,  /// SNAPSHOT, an image emitted by refresh
+};
+
+/// This class renders the fractal image.
+/// Just call start to start the process, after which you can render images.
+/// The image is split into tiles, that are rendered by a work-stealing
+/// pool using all cores (see setThreads).
+/// Each image uses the cheapest precision that resolves its pixels,
+/// deep zooms of the mandelbrot set and quadratic julia sets are
+/// calculated using Perturbation.
+/// The image is rendered in passes (see FractalGeometry::passes),
+/// from coarse to fine, and emitted at the end of each pass.
+/// Optionally solid areas are guessed, using Mariani-Silver subdivision.
+/// The iteration counts are kept in a FractalFrame, if only colours
+/// or images change, the image is coloured again without calculation,
+/// and if the view is panned, only the exposed part is calculated.
+/// Finished frames are kept in a FractalCache.
+/// Long renders can be checkpointed to a file, see setCheckpoint.
+/// The images are triple buffered, the renderer writes the back buffer,
+/// publishes it as the ready buffer, and the widget takes the ready 
+/// buffer as front buffer (see image), so no image is copied, and a
+/// buffer is only allocated when it is first written at a new size.
+/// \dot
+/// digraph RenderingState {
+///   node [shape=doublecircle]; INIT; STOPPED;
+///   node [shape=circle fixedsize width=1.5 height=1];
+///   {rank = same; INIT; STOPPED;}
+///   {rank = same; SKIP;}
+///   {rank = same; READY; PAUSED;}
+///   INIT      -> READY     [ label = "start" ];
+///   READY     -> START     [ label = "render" ];
+///   READY     -> STOPPED   [ label = "stop" ];
+///   READY     -> PAUSED    [ label = "pause" ];
+///   START     -> ACTIVE    [ label = "geo = m_geo" ];
+///   ACTIVE    -> PAUSED    [ label = "pause" ];
+///   ACTIVE    -> SKIP      [ label = "skip" ];
+///   ACTIVE    -> INTERRUPT [ label = "interrupt" ];
+///   ACTIVE    -> ACTIVE    [ label = "refresh" ];
+///   ACTIVE    -> STOPPED   [ label = "stop" ];
+///   ACTIVE    -> START     [ label = "render" ];
+///   ACTIVE    -> ACTIVE    [ label = "pass < geo.passes" ];
+///   ACTIVE    -> READY     [ label = "pass == geo.passes" ];
+///   PAUSED    -> ACTIVE    [ label = "cont" ];
+///   PAUSED    -> READY     [ label = "cont" ];
+///   PAUSED    -> STOPPED   [ label = "stop" ];
+///   INTERRUPT -> ACTIVE    [ label = "cont" ];
+///  }
+/// \enddot
+class FractalRenderer : public QThread
+{
+  Q_OBJECT
+
+public:
+  /// Constructor.
+  FractalRenderer(QObject* parent = 0);
+  
+  /// Destructor, stops rendering.
+ ~FractalRenderer();
+ 
+  /// Returns dir of the cache of finished frames on disk.
+  const auto & cacheDir() const {return m_cacheDir;};
+  
+  /// Returns disk budget of the cache of finished frames in bytes.
+  auto cacheDisk() const {return m_cacheDisk;};
+  
+  /// Returns memory budget of the cache of finished frames in bytes.
+  auto cacheSize() const {return m_cacheSize;};
+  
+  /// Returns file of the checkpoints.
+  const auto & checkpoint() const {return m_checkpoint;};
+  
+  /// Returns interval of the checkpoints in seconds.
+  auto checkpointInterval() const {return m_checkpointInterval;};
+  
+  /// Returns debounce time in milliseconds.
+  auto debounce() const {return m_debounce;};
+  
+  /// Returns the frame with the iteration counts of the last image,
+  /// it is only consistent if rendering is ready.
+  const auto & frame() const {return m_frame;};
+  
+  /// Returns generation of the last render request.
+  int generation() const {return m_generation;};
+  
+  /// Returns the last published image, the renderer does not write it
+  /// until a next image is taken.
+  QImage image();
+  
+  /// Interrupts rendering.
+  /// Call render or cont to render again.
+  void interrupt();
+ 
+  /// Process is interrupted, paused, stopped, or the request being
+  /// rendered is superseded.
+  /// This is a cancellation token, one relaxed atomic load, the kernels
+  /// poll it once for each number of iterations, and the renderer 
+  /// before each tile.
+  bool interrupted() const {
+    return m_cancel.load(std::memory_order_relaxed);};
+
+  /// Returns true if frames keep their orbits, see setKeepOrbits.
+  auto keepOrbits() const {return m_keepOrbits;};
+
+  /// Returns the fraction of the steps of the last image
+  /// that were guessed, see FractalGeometry::guess.
+  double guessed() const;
+
+  /// Returns the precision used for the last image,
+  /// see Fractal::precision.
+  FractalPrecision precision() const {return m_precision;};
+
+  /// Saves the frame of the last image in native format, 
+  /// see FractalFrame::save.
+  /// Returns false if rendering is not ready, or the file
+  /// could not be written.
+  bool saveFrame(const QString& file);
+
+  /// Sets dir and disk budget in bytes of the cache of finished frames
+  /// on disk, an empty dir disables it.
+  /// Takes effect when the next image is rendered.
+  void setCacheDisk(const QString& dir, size_t size);
+
+  /// Sets memory budget of the cache of finished frames in bytes, 
+  /// 0 disables the cache.
+  /// Takes effect when the next image is rendered.
+  void setCacheSize(size_t size);
+
+  /// Sets file and interval in seconds of checkpoints, an empty file
+  /// disables them. While an image is rendered, its frame is written
+  /// to the file each interval (0 only when interrupted, paused or 
+  /// stopped), and it is removed when the image is finished, or when
+  /// rendering of another image starts, e.g. after a pan.
+  /// A request for the image of the checkpoint, e.g. after a restart,
+  /// continues the checkpoint (see FractalFrame::load).
+  /// Takes effect when the next image is rendered.
+  void setCheckpoint(const QString& file, int seconds);
+
+  /// Sets debounce time in milliseconds, render requests within
+  /// this time of each other are coalesced, 0 renders each request.
+  void setDebounce(int ms);
+
+  /// Sets a frame, e.g. opened from a file (see FractalFrame::open).
+  /// A request for the image of the frame only colours it, the frame
+  /// is used once for that, as it then shares its counts with the last
+  /// image, and a request for a higher depth continues it if it is
+  /// resumable.
+  /// Takes effect when the next image is rendered.
+  void setFrame(const FractalFrame& frame);
+
+  /// Sets whether frames keep the orbit of each step that reached
+  /// the depth, so a higher depth only continues these steps
+  /// (see FractalFrame::resume). Off by default, it costs memory for
+  /// each such step, a frame that is opened continues anyway.
+  /// Takes effect when the next image is rendered.
+  void setKeepOrbits(bool keep);
+
+  /// Sets number of render threads, 0 uses all available cores.
+  /// Takes effect when the next image is rendered.
+  void setThreads(int threads);
+
+  /// Returns the stats of the interior shortcuts for the last image.
+  FractalStats stats() const;
+
+  /// Returns number of render threads, 0 means all available cores.
+  auto threads() const {return m_threads;};
+public slots:
+  /// Pauses or continues rendering.
+  void pause(bool checked) {checked ? pause(): cont();};
+  
+  /// Ask for a refresh, a rendered image will be emitted,
+  /// though the image will not be finished.
+  /// Rendering continues, the image is copied when the next tile 
+  /// is finished.
+  void refresh();
+    
+  /// Begins rendering the fractal into an image (if the process is started).
+  /// Each request gets a next generation, see generation. A request 
+  /// supersedes the request being rendered, that is not finished, 
+  /// and its images are no longer emitted.
+  /// Returns false if fractal or geometry not ok, or rendering is not allowed.
+  bool render(
+    /// using this fractal
+    const Fractal& fractal,
+    /// using this image size
+    const QSize& size,
+    /// using this geometry
+    const FractalGeometry& geometry);
+    
+  /// Restarts rendering.
+  void restart();
+  
+  /// Starts process.
+  void start() {QThread::start();};
+signals:
+  /// If an image is available, this signal is emitted,
+  /// take it using image.
+  void rendered(
+    /// the state
+    int state, 
+    /// generation of the request rendered
+    int generation);
+  
+  /// During rendering, this signal is emitted.
+  /// It signals current busy on line out of max lines.
+  void rendering(int line, int max);
+protected:
+  /// Overriden from base class.
+  virtual void run() override;
+private:
+  typedef std::function<bool(const std::vector<QPoint>&)> Calc;
+
+  QImage& back() {return m_buffers[m_back];};
+  template <typename T>
+  bool calcPoints(
+    const Fractal& fractal,
+    FractalKernel<T> kernel,
+    const FractalGeometry& geo,
+    const QSize& size,
+    const std::vector<QPoint>& points);
+  bool calcPointsPerturbation(
+    const Perturbation& perturbation,
+    const FractalGeometry& geo,
+    const QSize& size,
+    const std::vector<QPoint>& points);
+  const QSize calcStep(const FractalGeometry& geo) const;
+  const std::vector<QRect> calcTiles(
+    const QSize& size, const QSize& inc) const;
+  void cont();
+  bool guessTile(
+    const QRect& tile, 
+    const QSize& inc, 
+    const QRect& rect,
+    const Calc& calc,
+    const Fractal& fractal);
+  bool nextStateForCalcEnd();
+  void pause();
+  void publish(int state);
+  bool renderTile(
+    const QRect& tile, 
+    const QSize& inc, 
+    int block,
+    const Calc& calc,
+    const Fractal& fractal,
+    const FractalGeometry& geo,
+    const QSize& size);
+  bool renderTiles(
+    const Fractal& fractal,
+    const FractalGeometry& geometry,
+    const QSize& size);
+  void setState(int state);
+  void snapshot();
+  void stop();
+  bool superseded() const {return m_generation != m_rendering;};
+  
+  QWaitCondition m_condition;
+  mutable QMutex m_mutex;
+  QSize m_size;
+  
+  // the back, ready and front buffers, the indices of back and ready 
+  // are swapped by publish, of ready and front by image
+  QImage m_buffers[3];
+  QMutex m_buffersMutex;
+  int m_back = 0, m_ready = 1, m_front = 2;
+  bool m_published = false;
+  std::atomic<bool> m_snapshot{false};
+  
+  // the tiles add the orbits of their steps to the frame
+  QMutex m_orbitsMutex;
+  
+  // the state is only accessed holding the mutex, see setState
+  int m_state = RENDERING_INIT;
+  int m_debounce = 0;
+  int m_rendering = 0;
+  std::atomic<int> m_generation{0};
+  std::atomic<bool> m_cancel{false};
+  QElapsedTimer m_requested;
+  int m_oldState = RENDERING_INIT;
+  int m_threads = 0;
+  bool m_threadsChanged = false;
+  size_t m_cacheSize = FractalCache().size();
+  size_t m_cacheDisk = 0;
+  QString m_cacheDir;
+  QString m_checkpoint;
+  int m_checkpointInterval = 0;
+  bool m_keepOrbits = false;
+  
+  std::atomic<FractalPrecision> m_precision{PRECISION_DOUBLE};
+  
+  // the stats are only accessed holding the mutex
+  double m_guessed = 0;
+  FractalStats m_stats;
+  
+  Fractal m_fractal;
+  FractalCache m_cache;
+  FractalFrame m_frame;
+  FractalFrame m_opened;
+  FractalGeometry m_geo;
+  RenderPool m_pool;
+};
@@ -0,0 +1,1067 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      fractalsimd.cpp
+// Purpose:   Implementation of class FractalSimd
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "fractalsimd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FRACTAL_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// Number of iterations between checks for interruption.
+const int check_iterations = 256;
+
+FractalSimd::Isa FractalSimd::m_isa = FractalSimd::detect();
+
+// The kernels below must not use fused multiply add, otherwise
+// results differ from the scalar kernels (see -ffp-contract in core.pro).
+// There are kernels for double and for float, float has twice the lanes.
+// Each kernel iterates:
+//   x' = x * x - y * y + kr
+//   y' = x * y + x * y + ki
+// and a lane escapes if x' * x' + y' * y' > diverge2.
+// Lanes that escaped or are interior keep their z, at the end z is
+// stored, so points that did not escape can continue.
+// Every 4 iterations a lane is compared with its checkpoint, a close
+// return that is attracting is interior (Brent's cycle detection).
+// The checkpoint moves at each power of 2, so longer cycles are found
+// later. All kernels use the same schedule, so results are equal.
+
+// Squared distance of a close return to the checkpoint. For float
+// a distance of about 8 ulps at |z| = 1, so only orbits that returned
+// up to rounding are compared with the multiplier.
+static double cycleTolerance(double) {return 1e-20;}
+static float cycleTolerance(float) {return 1e-12f;}
+
+template <typename T>
+static bool escapeScalar(
+  T* zr, T* zi,
+  const T* kr, const T* ki,
+  int count, T diverge2, int max, int* n, int* cycles,
+  const std::function<bool()>& interrupted)
+{
+  for (int i = 0; i < count; i++)
+  {
+    T x = zr[i];
+    T y = zi[i];
+    T sx = x;
+    T sy = y;
+    int saved = 0;
+
+    for (n[i] = 0; n[i] < max; n[i]++)
+    {
+      const T xt = x * x - y * y + kr[i];
+      y = x * y + x * y + ki[i];
+      x = xt;
+
+      if (x * x + y * y > diverge2)
+      {
+        break;
+      }
+
+      const int j = n[i];
+
+      if ((j & 3) == 3)
+      {
+        const T dx = x - sx;
+        const T dy = y - sy;
+
+        if (dx * dx + dy * dy < cycleTolerance(diverge2) &&
+          FractalSimd::attracting(x, y, kr[i], ki[i], j + 1 - saved))
+        {
+          n[i] = max;
+          (*cycles)++;
+          break;
+        }
+
+        if (((j + 1) & j) == 0)
+        {
+          sx = x;
+          sy = y;
+          saved = j + 1;
+        }
+      }
+
+      if ((j % check_iterations) == check_iterations - 1 &&
+        interrupted && interrupted())
+      {
+        return false;
+      }
+    }
+
+    zr[i] = x;
+    zi[i] = y;
+  }
+
+  return true;
+}
+
+#ifdef FRACTAL_SIMD_X86
+__attribute__((target("sse2")))
+static bool escapeSse2(
+  double* zr, double* zi,
+  const double* kr, const double* ki,
+  int count, double diverge2, int max, int* n, int* cycles,
+  const std::function<bool()>& interrupted)
+{
+  const __m128d d2 = _mm_set1_pd(diverge2);
+  const __m128d one = _mm_set1_pd(1.0);
+  const __m128d tolerance = _mm_set1_pd(cycleTolerance(diverge2));
+  const __m128d last = _mm_set1_pd((double)max);
+
+  for (int i = 0; i < count; i += 2)
+  {
+    const int lanes = std::min(2, count - i);
+
+    alignas(16) double lane[4][2] = {{0}};
+    alignas(16) long long mask[2] = {0};
+
+    for (int l = 0; l < lanes; l++)
+    {
+      lane[0][l] = zr[i + l];
+      lane[1][l] = zi[i + l];
+      lane[2][l] = kr[i + l];
+      lane[3][l] = ki[i + l];
+      mask[l] = -1;
+    }
+
+    __m128d x = _mm_load_pd(lane[0]);
+    __m128d y = _mm_load_pd(lane[1]);
+    const __m128d cr = _mm_load_pd(lane[2]);
+    const __m128d ci = _mm_load_pd(lane[3]);
+    __m128d active = _mm_castsi128_pd(_mm_load_si128((const __m128i*)mask));
+    __m128d iter = _mm_setzero_pd();
+    __m128d sx = x;
+    __m128d sy = y;
+    int saved = 0;
+
+    for (int j = 0; j < max; j++)
+    {
+      const __m128d xy = _mm_mul_pd(x, y);
+      const __m128d xn =
+        _mm_add_pd(_mm_sub_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y)), cr);
+      const __m128d yn = _mm_add_pd(_mm_add_pd(xy, xy), ci);
+      x = _mm_or_pd(_mm_and_pd(active, xn), _mm_andnot_pd(active, x));
+      y = _mm_or_pd(_mm_and_pd(active, yn), _mm_andnot_pd(active, y));
+
+      const __m128d norm =
+        _mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y));
+      active = _mm_andnot_pd(_mm_cmpgt_pd(norm, d2), active);
+
+      if (_mm_movemask_pd(active) == 0)
+      {
+        break;
+      }
+
+      iter = _mm_add_pd(iter, _mm_and_pd(active, one));
+
+      if ((j & 3) == 3)
+      {
+        const __m128d dx = _mm_sub_pd(x, sx);
+        const __m128d dy = _mm_sub_pd(y, sy);
+        const __m128d dist =
+          _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+        const int close =
+          _mm_movemask_pd(_mm_and_pd(_mm_cmplt_pd(dist, tolerance), active));
+
+        if (close != 0)
+        {
+          alignas(16) double lx[2], ly[2];
+          _mm_store_pd(lx, x);
+          _mm_store_pd(ly, y);
+
+          int interior = 0;
+
+          for (int l = 0; l < lanes; l++)
+          {
+            if (((close >> l) & 1) && FractalSimd::attracting(
+              lx[l], ly[l], lane[2][l], lane[3][l], j + 1 - saved))
+            {
+              mask[l] = -1;
+              interior |= (1 << l);
+              (*cycles)++;
+            }
+            else
+            {
+              mask[l] = 0;
+            }
+          }
+
+          if (interior != 0)
+          {
+            const __m128d found =
+              _mm_castsi128_pd(_mm_load_si128((const __m128i*)mask));
+            iter = _mm_or_pd(
+              _mm_andnot_pd(found, iter), _mm_and_pd(found, last));
+            active = _mm_andnot_pd(found, active);
+
+            if (_mm_movemask_pd(active) == 0)
+            {
+              break;
+            }
+          }
+        }
+
+        // Brent: a new checkpoint at each power of 2
+        if (((j + 1) & j) == 0)
+        {
+          sx = x;
+          sy = y;
+          saved = j + 1;
+        }
+      }
+
+      if ((j % check_iterations) == check_iterations - 1 &&
+        interrupted && interrupted())
+      {
+        return false;
+      }
+    }
+
+    alignas(16) double result[2];
+    _mm_store_pd(result, iter);
+    _mm_store_pd(lane[0], x);
+    _mm_store_pd(lane[1], y);
+
+    for (int l = 0; l < lanes; l++)
+    {
+      n[i + l] = (int)result[l];
+      zr[i + l] = lane[0][l];
+      zi[i + l] = lane[1][l];
+    }
+  }
+
+  return true;
+}
+
+__attribute__((target("avx2")))
+static bool escapeAvx2(
+  double* zr, double* zi,
+  const double* kr, const double* ki,
+  int count, double diverge2, int max, int* n, int* cycles,
+  const std::function<bool()>& interrupted)
+{
+  const __m256d d2 = _mm256_set1_pd(diverge2);
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d tolerance = _mm256_set1_pd(cycleTolerance(diverge2));
+  const __m256d last = _mm256_set1_pd((double)max);
+
+  for (int i = 0; i < count; i += 4)
+  {
+    const int lanes = std::min(4, count - i);
+
+    alignas(32) double lane[4][4] = {{0}};
+    alignas(32) long long mask[4] = {0};
+
+    for (int l = 0; l < lanes; l++)
+    {
+      lane[0][l] = zr[i + l];
+      lane[1][l] = zi[i + l];
+      lane[2][l] = kr[i + l];
+      lane[3][l] = ki[i + l];
+      mask[l] = -1;
+    }
+
+    __m256d x = _mm256_load_pd(lane[0]);
+    __m256d y = _mm256_load_pd(lane[1]);
+    const __m256d cr = _mm256_load_pd(lane[2]);
+    const __m256d ci = _mm256_load_pd(lane[3]);
+    __m256d active =
+      _mm256_castsi256_pd(_mm256_load_si256((const __m256i*)mask));
+    __m256d iter = _mm256_setzero_pd();
+    __m256d sx = x;
+    __m256d sy = y;
+    int saved = 0;
+
+    for (int j = 0; j < max; j++)
+    {
+      const __m256d xy = _mm256_mul_pd(x, y);
+      const __m256d xn = _mm256_add_pd(
+        _mm256_sub_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), cr);
+      const __m256d yn = _mm256_add_pd(_mm256_add_pd(xy, xy), ci);
+      x = _mm256_blendv_pd(x, xn, active);
+      y = _mm256_blendv_pd(y, yn, active);
+
+      const __m256d norm =
+        _mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y));
+      active = _mm256_andnot_pd(_mm256_cmp_pd(norm, d2, _CMP_GT_OQ), active);
+
+      if (_mm256_movemask_pd(active) == 0)
+      {
+        break;
+      }
+
+      iter = _mm256_add_pd(iter, _mm256_and_pd(active, one));
+
+      if ((j & 3) == 3)
+      {
+        const __m256d dx = _mm256_sub_pd(x, sx);
+        const __m256d dy = _mm256_sub_pd(y, sy);
+        const __m256d dist =
+          _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+        const int close = _mm256_movemask_pd(
+          _mm256_and_pd(_mm256_cmp_pd(dist, tolerance, _CMP_LT_OQ), active));
+
+        if (close != 0)
+        {
+          alignas(32) double lx[4], ly[4];
+          _mm256_store_pd(lx, x);
+          _mm256_store_pd(ly, y);
+
+          int interior = 0;
+
+          for (int l = 0; l < lanes; l++)
+          {
+            if (((close >> l) & 1) && FractalSimd::attracting(
+              lx[l], ly[l], lane[2][l], lane[3][l], j + 1 - saved))
+            {
+              mask[l] = -1;
+              interior |= (1 << l);
+              (*cycles)++;
+            }
+            else
+            {
+              mask[l] = 0;
+            }
+          }
+
+          if (interior != 0)
+          {
+            const __m256d found =
+              _mm256_castsi256_pd(_mm256_load_si256((const __m256i*)mask));
+            iter = _mm256_or_pd(
+              _mm256_andnot_pd(found, iter), _mm256_and_pd(found, last));
+            active = _mm256_andnot_pd(found, active);
+
+            if (_mm256_movemask_pd(active) == 0)
+            {
+              break;
+            }
+          }
+        }
+
+        // Brent: a new checkpoint at each power of 2
+        if (((j + 1) & j) == 0)
+        {
+          sx = x;
+          sy = y;
+          saved = j + 1;
+        }
+      }
+
+      if ((j % check_iterations) == check_iterations - 1 &&
+        interrupted && interrupted())
+      {
+        return false;
+      }
+    }
+
+    alignas(32) double result[4];
+    _mm256_store_pd(result, iter);
+    _mm256_store_pd(lane[0], x);
+    _mm256_store_pd(lane[1], y);
+
+    for (int l = 0; l < lanes; l++)
+    {
+      n[i + l] = (int)result[l];
+      zr[i + l] = lane[0][l];
+      zi[i + l] = lane[1][l];
+    }
+  }
+
+  return true;
+}
+
+__attribute__((target("avx512f")))
+static bool escapeAvx512(
+  double* zr, double* zi,
+  const double* kr, const double* ki,
+  int count, double diverge2, int max, int* n, int* cycles,
+  const std::function<bool()>& interrupted)
+{
+  const __m512d d2 = _mm512_set1_pd(diverge2);
+  const __m512d one = _mm512_set1_pd(1.0);
+  const __m512d tolerance = _mm512_set1_pd(cycleTolerance(diverge2));
+  const __m512d last = _mm512_set1_pd((double)max);
+
+  for (int i = 0; i < count; i += 8)
+  {
+    const int lanes = std::min(8, count - i);
+
+    alignas(64) double lane[4][8] = {{0}};
+
+    for (int l = 0; l < lanes; l++)
+    {
+      lane[0][l] = zr[i + l];
+      lane[1][l] = zi[i + l];
+      lane[2][l] = kr[i + l];
+      lane[3][l] = ki[i + l];
+    }
+
+    __m512d x = _mm512_load_pd(lane[0]);
+    __m512d y = _mm512_load_pd(lane[1]);
+    const __m512d cr = _mm512_load_pd(lane[2]);
+    const __m512d ci = _mm512_load_pd(lane[3]);
+    __mmask8 active = (__mmask8)((1 << lanes) - 1);
+    __m512d iter = _mm512_setzero_pd();
+    __m512d sx = x;
+    __m512d sy = y;
+    int saved = 0;
+
+    for (int j = 0; j < max; j++)
+    {
+      const __m512d xy = _mm512_mul_pd(x, y);
+      const __m512d xn = _mm512_add_pd(
+        _mm512_sub_pd(_mm512_mul_pd(x, x), _mm512_mul_pd(y, y)), cr);
+      const __m512d yn = _mm512_add_pd(_mm512_add_pd(xy, xy), ci);
+      x = _mm512_mask_mov_pd(x, active, xn);
+      y = _mm512_mask_mov_pd(y, active, yn);
+
+      const __m512d norm =
+        _mm512_add_pd(_mm512_mul_pd(x, x), _mm512_mul_pd(y, y));
+      active &= ~_mm512_cmp_pd_mask(norm, d2, _CMP_GT_OQ);
+
+      if (active == 0)
+      {
+        break;
+      }
+
+      iter = _mm512_mask_add_pd(iter, active, iter, one);
+
+      if ((j & 3) == 3)
+      {
+        const __m512d dx = _mm512_sub_pd(x, sx);
+        const __m512d dy = _mm512_sub_pd(y, sy);
+        const __m512d dist =
+          _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy));
+        const int close =
+          active & _mm512_cmp_pd_mask(dist, tolerance, _CMP_LT_OQ);
+
+        if (close != 0)
+        {
+          alignas(64) double lx[8], ly[8];
+          _mm512_store_pd(lx, x);
+          _mm512_store_pd(ly, y);
+
+          int interior = 0;
+
+          for (int l = 0; l < lanes; l++)
+          {
+            if (((close >> l) & 1) && FractalSimd::attracting(
+              lx[l], ly[l], lane[2][l], lane[3][l], j + 1 - saved))
+            {
+              interior |= (1 << l);
+              (*cycles)++;
+            }
+          }
+
+          if (interior != 0)
+          {
+            iter = _mm512_mask_mov_pd(iter, (__mmask8)interior, last);
+            active &= ~(__mmask8)interior;
+
+            if (active == 0)
+            {
+              break;
+            }
+          }
+        }
+
+        // Brent: a new checkpoint at each power of 2
+        if (((j + 1) & j) == 0)
+        {
+          sx = x;
+          sy = y;
+          saved = j + 1;
+        }
+      }
+
+      if ((j % check_iterations) == check_iterations - 1 &&
+        interrupted && interrupted())
+      {
+        return false;
+      }
+    }
+
+    alignas(64) double result[8];
+    _mm512_store_pd(result, iter);
+    _mm512_store_pd(lane[0], x);
+    _mm512_store_pd(lane[1], y);
+
+    for (int l = 0; l < lanes; l++)
+    {
+      n[i + l] = (int)result[l];
+      zr[i + l] = lane[0][l];
+      zi[i + l] = lane[1][l];
+    }
+  }
+
+  return true;
+}
+
+__attribute__((target("sse2")))
+static bool escapeSse2(
+  float* zr, float* zi,
+  const float* kr, const float* ki,
+  int count, float diverge2, int max, int* n, int* cycles,
+  const std::function<bool()>& interrupted)
+{
+  const __m128 d2 = _mm_set1_ps(diverge2);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 tolerance = _mm_set1_ps(cycleTolerance(diverge2));
+  const __m128 last = _mm_set1_ps((float)max);
+
+  for (int i = 0; i < count; i += 4)
+  {
+    const int lanes = std::min(4, count - i);
+
+    alignas(16) float lane[4][4] = {{0}};
+    alignas(16) int mask[4] = {0};
+
+    for (int l = 0; l < lanes; l++)
+    {
+      lane[0][l] = zr[i + l];
+      lane[1][l] = zi[i + l];
+      lane[2][l] = kr[i + l];
+      lane[3][l] = ki[i + l];
+      mask[l] = -1;
+    }
+
+    __m128 x = _mm_load_ps(lane[0]);
+    __m128 y = _mm_load_ps(lane[1]);
+    const __m128 cr = _mm_load_ps(lane[2]);
+    const __m128 ci = _mm_load_ps(lane[3]);
+    __m128 active = _mm_castsi128_ps(_mm_load_si128((const __m128i*)mask));
+    __m128 iter = _mm_setzero_ps();
+    __m128 sx = x;
+    __m128 sy = y;
+    int saved = 0;
+
+    for (int j = 0; j < max; j++)
+    {
+      const __m128 xy = _mm_mul_ps(x, y);
+      const __m128 xn =
+        _mm_add_ps(_mm_sub_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), cr);
+      const __m128 yn = _mm_add_ps(_mm_add_ps(xy, xy), ci);
+      x = _mm_or_ps(_mm_and_ps(active, xn), _mm_andnot_ps(active, x));
+      y = _mm_or_ps(_mm_and_ps(active, yn), _mm_andnot_ps(active, y));
+
+      const __m128 norm =
+        _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+      active = _mm_andnot_ps(_mm_cmpgt_ps(norm, d2), active);
+
+      if (_mm_movemask_ps(active) == 0)
+      {
+        break;
+      }
+
+      iter = _mm_add_ps(iter, _mm_and_ps(active, one));
+
+      if ((j & 3) == 3)
+      {
+        const __m128 dx = _mm_sub_ps(x, sx);
+        const __m128 dy = _mm_sub_ps(y, sy);
+        const __m128 dist =
+          _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        const int close =
+          _mm_movemask_ps(_mm_and_ps(_mm_cmplt_ps(dist, tolerance), active));
+
+        if (close != 0)
+        {
+          alignas(16) float lx[4], ly[4];
+          _mm_store_ps(lx, x);
+          _mm_store_ps(ly, y);
+
+          int interior = 0;
+
+          for (int l = 0; l < lanes; l++)
+          {
+            if (((close >> l) & 1) && FractalSimd::attracting(
+              lx[l], ly[l], lane[2][l], lane[3][l], j + 1 - saved))
+            {
+              mask[l] = -1;
+              interior |= (1 << l);
+              (*cycles)++;
+            }
+            else
+            {
+              mask[l] = 0;
+            }
+          }
+
+          if (interior != 0)
+          {
+            const __m128 found =
+              _mm_castsi128_ps(_mm_load_si128((const __m128i*)mask));
+            iter = _mm_or_ps(
+              _mm_andnot_ps(found, iter), _mm_and_ps(found, last));
+            active = _mm_andnot_ps(found, active);
+
+            if (_mm_movemask_ps(active) == 0)
+            {
+              break;
+            }
+          }
+        }
+
+        // Brent: a new checkpoint at each power of 2
+        if (((j + 1) & j) == 0)
+        {
+          sx = x;
+          sy = y;
+          saved = j + 1;
+        }
+      }
+
+      if ((j % check_iterations) == check_iterations - 1 &&
+        interrupted && interrupted())
+      {
+        return false;
+      }
+    }
+
+    alignas(16) float result[4];
+    _mm_store_ps(result, iter);
+    _mm_store_ps(lane[0], x);
+    _mm_store_ps(lane[1], y);
+
+    for (int l = 0; l < lanes; l++)
+    {
+      n[i + l] = (int)result[l];
+      zr[i + l] = lane[0][l];
+      zi[i + l] = lane[1][l];
+    }
+  }
+
+  return true;
+}
+
+__attribute__((target("avx2")))
+static bool escapeAvx2(
+  float* zr, float* zi,
+  const float* kr, const float* ki,
+  int count, float diverge2, int max, int* n, int* cycles,
+  const std::function<bool()>& interrupted)
+{
+  const __m256 d2 = _mm256_set1_ps(diverge2);
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 tolerance = _mm256_set1_ps(cycleTolerance(diverge2));
+  const __m256 last = _mm256_set1_ps((float)max);
+
+  for (int i = 0; i < count; i += 8)
+  {
+    const int lanes = std::min(8, count - i);
+
+    alignas(32) float lane[4][8] = {{0}};
+    alignas(32) int mask[8] = {0};
+
+    for (int l = 0; l < lanes; l++)
+    {
+      lane[0][l] = zr[i + l];
+      lane[1][l] = zi[i + l];
+      lane[2][l] = kr[i + l];
+      lane[3][l] = ki[i + l];
+      mask[l] = -1;
+    }
+
+    __m256 x = _mm256_load_ps(lane[0]);
+    __m256 y = _mm256_load_ps(lane[1]);
+    const __m256 cr = _mm256_load_ps(lane[2]);
+    const __m256 ci = _mm256_load_ps(lane[3]);
+    __m256 active =
+      _mm256_castsi256_ps(_mm256_load_si256((const __m256i*)mask));
+    __m256 iter = _mm256_setzero_ps();
+    __m256 sx = x;
+    __m256 sy = y;
+    int saved = 0;
+
+    for (int j = 0; j < max; j++)
+    {
+      const __m256 xy = _mm256_mul_ps(x, y);
+      const __m256 xn = _mm256_add_ps(
+        _mm256_sub_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), cr);
+      const __m256 yn = _mm256_add_ps(_mm256_add_ps(xy, xy), ci);
+      x = _mm256_blendv_ps(x, xn, active);
+      y = _mm256_blendv_ps(y, yn, active);
+
+      const __m256 norm =
+        _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+      active = _mm256_andnot_ps(_mm256_cmp_ps(norm, d2, _CMP_GT_OQ), active);
+
+      if (_mm256_movemask_ps(active) == 0)
+      {
+        break;
+      }
+
+      iter = _mm256_add_ps(iter, _mm256_and_ps(active, one));
+
+      if ((j & 3) == 3)
+      {
+        const __m256 dx = _mm256_sub_ps(x, sx);
+        const __m256 dy = _mm256_sub_ps(y, sy);
+        const __m256 dist =
+          _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        const int close = _mm256_movemask_ps(
+          _mm256_and_ps(_mm256_cmp_ps(dist, tolerance, _CMP_LT_OQ), active));
+
+        if (close != 0)
+        {
+          alignas(32) float lx[8], ly[8];
+          _mm256_store_ps(lx, x);
+          _mm256_store_ps(ly, y);
+
+          int interior = 0;
+
+          for (int l = 0; l < lanes; l++)
+          {
+            if (((close >> l) & 1) && FractalSimd::attracting(
+              lx[l], ly[l], lane[2][l], lane[3][l], j + 1 - saved))
+            {
+              mask[l] = -1;
+              interior |= (1 << l);
+              (*cycles)++;
+            }
+            else
+            {
+              mask[l] = 0;
+            }
+          }
+
+          if (interior != 0)
+          {
+            const __m256 found =
+              _mm256_castsi256_ps(_mm256_load_si256((const __m256i*)mask));
+            iter = _mm256_or_ps(
+              _mm256_andnot_ps(found, iter), _mm256_and_ps(found, last));
+            active = _mm256_andnot_ps(found, active);
+
+            if (_mm256_movemask_ps(active) == 0)
+            {
+              break;
+            }
+          }
+        }
+
+        // Brent: a new checkpoint at each power of 2
+        if (((j + 1) & j) == 0)
+        {
+          sx = x;
+          sy = y;
+          saved = j + 1;
+        }
+      }
+
+      if ((j % check_iterations) == check_iterations - 1 &&
+        interrupted && interrupted())
+      {
+        return false;
+      }
+    }
+
+    alignas(32) float result[8];
+    _mm256_store_ps(result, iter);
+    _mm256_store_ps(lane[0], x);
+    _mm256_store_ps(lane[1], y);
+
+    for (int l = 0; l < lanes; l++)
+    {
+      n[i + l] = (int)result[l];
+      zr[i + l] = lane[0][l];
+      zi[i + l] = lane[1][l];
+    }
+  }
+
+  return true;
+}
+
+__attribute__((target("avx512f")))
+static bool escapeAvx512(
+  float* zr, float* zi,
+  const float* kr, const float* ki,
+  int count, float diverge2, int max, int* n, int* cycles,
+  const std::function<bool()>& interrupted)
+{
+  const __m512 d2 = _mm512_set1_ps(diverge2);
+  const __m512 one = _mm512_set1_ps(1.0f);
+  const __m512 tolerance = _mm512_set1_ps(cycleTolerance(diverge2));
+  const __m512 last = _mm512_set1_ps((float)max);
+
+  for (int i = 0; i < count; i += 16)
+  {
+    const int lanes = std::min(16, count - i);
+
+    alignas(64) float lane[4][16] = {{0}};
+
+    for (int l = 0; l < lanes; l++)
+    {
+      lane[0][l] = zr[i + l];
+      lane[1][l] = zi[i + l];
+      lane[2][l] = kr[i + l];
+      lane[3][l] = ki[i + l];
+    }
+
+    __m512 x = _mm512_load_ps(lane[0]);
+    __m512 y = _mm512_load_ps(lane[1]);
+    const __m512 cr = _mm512_load_ps(lane[2]);
+    const __m512 ci = _mm512_load_ps(lane[3]);
+    __mmask16 active = (__mmask16)((1 << lanes) - 1);
+    __m512 iter = _mm512_setzero_ps();
+    __m512 sx = x;
+    __m512 sy = y;
+    int saved = 0;
+
+    for (int j = 0; j < max; j++)
+    {
+      const __m512 xy = _mm512_mul_ps(x, y);
+      const __m512 xn = _mm512_add_ps(
+        _mm512_sub_ps(_mm512_mul_ps(x, x), _mm512_mul_ps(y, y)), cr);
+      const __m512 yn = _mm512_add_ps(_mm512_add_ps(xy, xy), ci);
+      x = _mm512_mask_mov_ps(x, active, xn);
+      y = _mm512_mask_mov_ps(y, active, yn);
+
+      const __m512 norm =
+        _mm512_add_ps(_mm512_mul_ps(x, x), _mm512_mul_ps(y, y));
+      active &= ~_mm512_cmp_ps_mask(norm, d2, _CMP_GT_OQ);
+
+      if (active == 0)
+      {
+        break;
+      }
+
+      iter = _mm512_mask_add_ps(iter, active, iter, one);
+
+      if ((j & 3) == 3)
+      {
+        const __m512 dx = _mm512_sub_ps(x, sx);
+        const __m512 dy = _mm512_sub_ps(y, sy);
+        const __m512 dist =
+          _mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy));
+        const int close =
+          active & _mm512_cmp_ps_mask(dist, tolerance, _CMP_LT_OQ);
+
+        if (close != 0)
+        {
+          alignas(64) float lx[16], ly[16];
+          _mm512_store_ps(lx, x);
+          _mm512_store_ps(ly, y);
+
+          int interior = 0;
+
+          for (int l = 0; l < lanes; l++)
+          {
+            if (((close >> l) & 1) && FractalSimd::attracting(
+              lx[l], ly[l], lane[2][l], lane[3][l], j + 1 - saved))
+            {
+              interior |= (1 << l);
+              (*cycles)++;
+            }
+          }
+
+          if (interior != 0)
+          {
+            iter = _mm512_mask_mov_ps(iter, (__mmask16)interior, last);
+            active &= ~(__mmask16)interior;
+
+            if (active == 0)
+            {
+              break;
+            }
+          }
+        }
+
+        // Brent: a new checkpoint at each power of 2
+        if (((j + 1) & j) == 0)
+        {
+          sx = x;
+          sy = y;
+          saved = j + 1;
+        }
+      }
+
+      if ((j % check_iterations) == check_iterations - 1 &&
+        interrupted && interrupted())
+      {
+        return false;
+      }
+    }
+
+    alignas(64) float result[16];
+    _mm512_store_ps(result, iter);
+    _mm512_store_ps(lane[0], x);
+    _mm512_store_ps(lane[1], y);
+
+    for (int l = 0; l < lanes; l++)
+    {
+      n[i + l] = (int)result[l];
+      zr[i + l] = lane[0][l];
+      zi[i + l] = lane[1][l];
+    }
+  }
+
+  return true;
+}
+
+#endif
+
+bool FractalSimd::attracting(
+  double x, double y, double kr, double ki, int period)
+{
+  // d = product of 2 z over the cycle
+  double dr = 1;
+  double di = 0;
+
+  for (int i = 0; i < period; i++)
+  {
+    const double dt = 2 * (x * dr - y * di);
+    di = 2 * (x * di + y * dr);
+    dr = dt;
+
+    const double xt = x * x - y * y + kr;
+    y = x * y + x * y + ki;
+    x = xt;
+
+    if (dr * dr + di * di > 1e200)
+    {
+      return false;
+    }
+  }
+
+  return dr * dr + di * di < 1;
+}
+
+FractalSimd::Isa FractalSimd::detect()
+{
+#ifdef FRACTAL_SIMD_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx512f"))
+  {
+    return ISA_AVX512;
+  }
+  else if (__builtin_cpu_supports("avx2"))
+  {
+    return ISA_AVX2;
+  }
+  else if (__builtin_cpu_supports("sse2"))
+  {
+    return ISA_SSE2;
+  }
+#endif
+
+  return ISA_NONE;
+}
+
+bool FractalSimd::escape(
+  double* zr, double* zi,
+  const double* kr, const double* ki,
+  int count, double diverge2, int max, int* n, int* cycles,
+  const std::function<bool()>& interrupted)
+{
+  int found = 0;
+  bool result;
+
+  switch (m_isa)
+  {
+#ifdef FRACTAL_SIMD_X86
+    case ISA_AVX512:
+      result = escapeAvx512(
+        zr, zi, kr, ki, count, diverge2, max, n, &found, interrupted);
+      break;
+    case ISA_AVX2:
+      result = escapeAvx2(
+        zr, zi, kr, ki, count, diverge2, max, n, &found, interrupted);
+      break;
+    case ISA_SSE2:
+      result = escapeSse2(
+        zr, zi, kr, ki, count, diverge2, max, n, &found, interrupted);
+      break;
+#endif
+    default:
+      result = escapeScalar(
+        zr, zi, kr, ki, count, diverge2, max, n, &found, interrupted);
+      break;
+  }
+
+  if (cycles != nullptr)
+  {
+    *cycles += found;
+  }
+
+  return result;
+}
+
+bool FractalSimd::escape(
+  float* zr, float* zi,
+  const float* kr, const float* ki,
+  int count, float diverge2, int max, int* n, int* cycles,
+  const std::function<bool()>& interrupted)
+{
+  int found = 0;
+  bool result;
+
+  switch (m_isa)
+  {
+#ifdef FRACTAL_SIMD_X86
+    case ISA_AVX512:
+      result = escapeAvx512(
+        zr, zi, kr, ki, count, diverge2, max, n, &found, interrupted);
+      break;
+    case ISA_AVX2:
+      result = escapeAvx2(
+        zr, zi, kr, ki, count, diverge2, max, n, &found, interrupted);
+      break;
+    case ISA_SSE2:
+      result = escapeSse2(
+        zr, zi, kr, ki, count, diverge2, max, n, &found, interrupted);
+      break;
+#endif
+    default:
+      result = escapeScalar(
+        zr, zi, kr, ki, count, diverge2, max, n, &found, interrupted);
+      break;
+  }
+
+  if (cycles != nullptr)
+  {
+    *cycles += found;
+  }
+
+  return result;
+}
+
+FractalSimd::Isa FractalSimd::isa()
+{
+  return m_isa;
+}
+
+const char* FractalSimd::isaName()
+{
+  switch (m_isa)
+  {
+    case ISA_AVX512: return "avx512";
+    case ISA_AVX2: return "avx2";
+    case ISA_SSE2: return "sse2";
+    default: return "scalar";
+  }
+}
+
+int FractalSimd::lanes()
+{
+  switch (m_isa)
+  {
+    case ISA_AVX512: return 8;
+    case ISA_AVX2: return 4;
+    case ISA_SSE2: return 2;
+    default: return 1;
+  }
+}
+
+void FractalSimd::setIsa(Isa isa)
+{
+  m_isa = std::min(isa, detect());
+}
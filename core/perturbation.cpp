@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      perturbation.cpp
+// Purpose:   Implementation of class Perturbation
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "perturbation.h"
+#include "fractal.h"
+
+// Number of iterations between checks for interruption.
+const int check_iterations = 1024;
+
+// A point is glitched if |Z + d|^2 < tolerance * |Z|^2.
+const double glitch_tolerance = 1e-6;
+
+// Max number of new references for glitched points for each calc.
+const int max_references = 8;
+
+Perturbation::Perturbation(
+  const Fractal& fractal,
+  const BigReal& x,
+  const BigReal& y,
+  int max)
+  : m_mandelbrot(fractal.isMandelbrot())
+  , m_diverge2(fractal.diverge() * fractal.diverge())
+  , m_julia(fractal.julia())
+  , m_max(max)
+  , m_x(x)
+  , m_y(y)
+{
+}
+
+bool Perturbation::calc(
+  const std::complex<double>* dc,
+  int* n,
+  int count,
+  const std::function<bool()>& interrupted) const
+{
+  std::vector<int> glitched;
+  bool glitch = false;
+
+  for (int i = 0; i < count; i++)
+  {
+    if (!iterate(m_orbit, dc[i], n[i], glitch, interrupted))
+    {
+      return false;
+    }
+
+    if (glitch)
+    {
+      glitched.push_back(i);
+    }
+  }
+
+  // Take a new reference at one of the glitched points,
+  // this point itself is never glitched, so each new reference
+  // resolves at least one point.
+  for (int r = 0; r < max_references && !glitched.empty(); r++)
+  {
+    Orbit orbit;
+
+    if (!this->orbit(orbit, dc[glitched[glitched.size() / 2]], interrupted))
+    {
+      return false;
+    }
+
+    m_references++;
+
+    std::vector<int> remaining;
+
+    for (const auto i : glitched)
+    {
+      if (!iterate(orbit, dc[i] - orbit.m_dc, n[i], glitch, interrupted))
+      {
+        return false;
+      }
+
+      if (glitch)
+      {
+        remaining.push_back(i);
+      }
+    }
+
+    glitched.swap(remaining);
+  }
+
+  // Points still glitched are calculated directly in high precision,
+  // the orbit of each one is a reference itself.
+  for (const auto i : glitched)
+  {
+    Orbit orbit;
+
+    if (!this->orbit(orbit, dc[i], interrupted))
+    {
+      return false;
+    }
+
+    n[i] = (std::norm(orbit.m_z.back()) > m_diverge2 ? 
+      orbit.m_z.size() - 2: m_max);
+  }
+
+  return true;
+}
+
+bool Perturbation::iterate(
+  const Orbit& orbit,
+  const std::complex<double>& dc,
+  int& n,
+  bool& glitch,
+  const std::function<bool()>& interrupted) const
+{
+  const int size = orbit.m_z.size();
+  const std::complex<double> k(m_mandelbrot ? -dc: 0.0);
+  std::complex<double> d(m_mandelbrot ? 0.0: dc);
+
+  glitch = false;
+
+  for (n = 0; n < m_max; n++)
+  {
+    // the reference escaped before this point
+    if (n + 1 >= size)
+    {
+      glitch = true;
+      break;
+    }
+
+    d = 2.0 * orbit.m_z[n] * d + d * d + k;
+
+    const double norm = std::norm(orbit.m_z[n + 1] + d);
+
+    if (norm > m_diverge2)
+    {
+      break;
+    }
+
+    if (norm < glitch_tolerance * std::norm(orbit.m_z[n + 1]))
+    {
+      glitch = true;
+      break;
+    }
+
+    if ((n % check_iterations) == check_iterations - 1 &&
+      interrupted && interrupted())
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool Perturbation::orbit(
+  Orbit& orbit,
+  const std::complex<double>& dc,
+  const std::function<bool()>& interrupted) const
+{
+  const int limbs = std::max(m_x.limbs(), m_y.limbs());
+  const BigReal cx(m_x + BigReal(dc.real(), limbs));
+  const BigReal cy(m_y + BigReal(dc.imag(), limbs));
+  const BigReal kr(m_mandelbrot ? -cx: BigReal(m_julia.real(), limbs));
+  const BigReal ki(m_mandelbrot ? -cy: BigReal(m_julia.imag(), limbs));
+
+  BigReal x(m_mandelbrot ? BigReal(0, limbs): cx);
+  BigReal y(m_mandelbrot ? BigReal(0, limbs): cy);
+
+  orbit.m_dc = dc;
+  orbit.m_z.clear();
+  orbit.m_z.push_back(std::complex<double>(x.toDouble(), y.toDouble()));
+
+  for (int n = 0; n < m_max; n++)
+  {
+    const BigReal xy(x * y);
+    x = x * x - y * y + kr;
+    y = xy + xy + ki;
+
+    const std::complex<double> z(x.toDouble(), y.toDouble());
+    orbit.m_z.push_back(z);
+
+    if (std::norm(z) > m_diverge2)
+    {
+      break;
+    }
+
+    if ((n % check_iterations) == check_iterations - 1 &&
+      interrupted && interrupted())
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool Perturbation::reference(const std::function<bool()>& interrupted)
+{
+  if (!orbit(m_orbit, 0, interrupted))
+  {
+    return false;
+  }
+
+  m_references = 1;
+  m_ready = true;
+
+  return true;
+}
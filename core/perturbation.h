@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      perturbation.h
+// Purpose:   Declaration of class Perturbation
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <complex>
+#include <functional>
+#include <vector>
+#include "bigreal.h"
+
+class Fractal;
+
+/// This class offers perturbation theory calculation for deep zooms,
+/// for the mandelbrot set and quadratic julia sets.
+/// One reference orbit Z is calculated in high precision, and each point
+/// is iterated in double precision as a delta d from this orbit:
+///   d' = 2 Z d + d^2 + k
+/// with k = -dc for the mandelbrot set (z = z^2 - c), and k = 0 for
+/// a julia set (where d starts at dc).
+/// A point is glitched if |Z + d| becomes much smaller than |Z|, or if
+/// the reference orbit escapes before the point does. Glitched points
+/// are calculated again using a new reference at one of them, points
+/// still glitched after a number of new references are calculated
+/// directly in high precision.
+/// It is used for views that double-double cannot resolve,
+/// see Fractal::precision.
+class Perturbation
+{
+public:
+  /// Constructor.
+  Perturbation(
+    /// the fractal
+    const Fractal& fractal,
+    /// real part of reference point
+    const BigReal& x,
+    /// imag part of reference point
+    const BigReal& y,
+    /// max iterations
+    int max);
+
+  /// Calculates a number of points, given as deltas from the reference
+  /// point. The reference orbit must be calculated first.
+  /// Returns false if interrupted.
+  bool calc(
+    /// deltas from reference point
+    const std::complex<double>* dc,
+    /// receives number of iterations before diverge
+    int* n,
+    /// number of points
+    int count,
+    /// if it returns true calculation stops
+    const std::function<bool()>& interrupted = std::function<bool()>()) const;
+
+  /// Returns true if the reference orbit is calculated.
+  bool isReady() const {return m_ready;};
+
+  /// Calculates the reference orbit.
+  /// Returns false if interrupted.
+  bool reference(
+    /// if it returns true calculation stops
+    const std::function<bool()>& interrupted = std::function<bool()>());
+
+  /// Returns number of reference orbits used, including the first one.
+  int references() const {return m_references;};
+private:
+  struct Orbit
+  {
+    std::vector<std::complex<double>> m_z;
+    std::complex<double> m_dc;
+  };
+
+  bool iterate(
+    const Orbit& orbit,
+    const std::complex<double>& dc,
+    int& n,
+    bool& glitch,
+    const std::function<bool()>& interrupted) const;
+  bool orbit(
+    Orbit& orbit,
+    const std::complex<double>& dc,
+    const std::function<bool()>& interrupted) const;
+
+  const bool m_mandelbrot;
+  const double m_diverge2;
+  const std::complex<double> m_julia;
+  const int m_max;
+  const BigReal m_x;
+  const BigReal m_y;
+
+  Orbit m_orbit;
+  bool m_ready = false;
+
+  mutable std::atomic<int> m_references{0};
+};
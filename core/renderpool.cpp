@@ -0,0 +1,182 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      renderpool.cpp
+// Purpose:   Implementation of class RenderPool
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "renderpool.h"
+
+RenderPool::RenderPool(int threads)
+{
+  start(threads);
+}
+
+RenderPool::~RenderPool()
+{
+  stop();
+}
+
+bool RenderPool::pop(int worker, int& index)
+{
+  Queue& queue(*m_queues[worker]);
+  std::lock_guard<std::mutex> lock(queue.m_mutex);
+
+  if (queue.m_tasks.empty())
+  {
+    return false;
+  }
+
+  index = queue.m_tasks.front();
+  queue.m_tasks.pop_front();
+
+  return true;
+}
+
+void RenderPool::run(int count, const Task& task, const Progress& progress)
+{
+  if (count <= 0)
+  {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  m_task = &task;
+  m_pending = count;
+
+  // Distribute round robin, so each worker gets tasks from all over
+  // the image, and the image fills evenly.
+  for (int i = 0; i < count; i++)
+  {
+    Queue& queue(*m_queues[i % m_queues.size()]);
+    std::lock_guard<std::mutex> qlock(queue.m_mutex);
+    queue.m_tasks.push_back(i);
+  }
+
+  m_generation++;
+  m_wake.notify_all();
+
+  int reported = 0;
+
+  while (m_pending > 0)
+  {
+    m_done.wait(lock);
+
+    const int finished = count - m_pending;
+
+    if (progress && finished != reported)
+    {
+      reported = finished;
+      lock.unlock();
+      progress(finished);
+      lock.lock();
+    }
+  }
+
+  m_task = nullptr;
+}
+
+void RenderPool::setThreads(int threads)
+{
+  stop();
+  start(threads);
+}
+
+void RenderPool::start(int threads)
+{
+  if (threads <= 0)
+  {
+    threads = std::max(1, (int)std::thread::hardware_concurrency());
+  }
+
+  m_stop = false;
+
+  for (int i = 0; i < threads; i++)
+  {
+    m_queues.push_back(std::make_unique<Queue>());
+  }
+
+  for (int i = 0; i < threads; i++)
+  {
+    m_workers.emplace_back(&RenderPool::work, this, i);
+  }
+}
+
+bool RenderPool::steal(int worker, int& index)
+{
+  const int size = m_queues.size();
+
+  for (int i = 1; i < size; i++)
+  {
+    Queue& queue(*m_queues[(worker + i) % size]);
+    std::lock_guard<std::mutex> lock(queue.m_mutex);
+
+    if (!queue.m_tasks.empty())
+    {
+      index = queue.m_tasks.back();
+      queue.m_tasks.pop_back();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void RenderPool::stop()
+{
+  {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_stop = true;
+  m_wake.notify_all();
+  }
+
+  for (auto& worker : m_workers)
+  {
+    worker.join();
+  }
+
+  m_workers.clear();
+  m_queues.clear();
+}
+
+void RenderPool::work(int worker)
+{
+  int generation = 0;
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  for (;;)
+  {
+    m_wake.wait(lock, [&] {return m_stop || m_generation != generation;});
+
+    if (m_stop)
+    {
+      return;
+    }
+
+    generation = m_generation;
+    lock.unlock();
+
+    int index;
+
+    while (pop(worker, index) || steal(worker, index))
+    {
+      // The task is only read after an index was taken, a new run
+      // sets the task before it queues any index.
+      lock.lock();
+      const Task* task = m_task;
+      lock.unlock();
+
+      (*task)(index);
+
+      lock.lock();
+      m_pending--;
+      m_done.notify_one();
+      lock.unlock();
+    }
+
+    lock.lock();
+  }
+}
@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      renderpool.h
+// Purpose:   Declaration of class RenderPool
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// This class offers a work-stealing thread pool.
+/// Each worker owns a queue of tasks, and takes tasks from the front
+/// of its own queue. If its own queue is empty, it steals tasks from the
+/// back of the queues of the other workers.
+class RenderPool
+{
+public:
+  /// A task, receives the index of the task to execute.
+  typedef std::function<void(int)> Task;
+
+  /// Progress callback, receives the number of finished tasks.
+  typedef std::function<void(int)> Progress;
+
+  /// Constructor.
+  RenderPool(
+    /// number of worker threads, 0 uses all available cores
+    int threads = 0);
+
+  /// Destructor, stops all workers.
+ ~RenderPool();
+
+  /// Runs count tasks, and returns when all tasks are finished.
+  /// The progress callback is invoked on the calling thread.
+  void run(
+    /// number of tasks
+    int count,
+    /// the task to execute for each index
+    const Task& task,
+    /// the progress callback
+    const Progress& progress = Progress());
+
+  /// Sets number of worker threads, 0 uses all available cores.
+  /// Do not call this during run.
+  void setThreads(int threads);
+
+  /// Returns number of worker threads.
+  auto threads() const {return (int)m_workers.size();};
+private:
+  struct Queue
+  {
+    std::deque<int> m_tasks;
+    std::mutex m_mutex;
+  };
+
+  bool pop(int worker, int& index);
+  bool steal(int worker, int& index);
+  void start(int threads);
+  void stop();
+  void work(int worker);
+
+  std::vector<std::thread> m_workers;
+  std::vector<std::unique_ptr<Queue>> m_queues;
+
+  std::condition_variable m_done;
+  std::condition_variable m_wake;
+  std::mutex m_mutex;
+
+  const Task* m_task = nullptr;
+
+  int m_generation = 0;
+  int m_pending = 0;
+  bool m_stop = false;
+};
@@ -5,41 +5,17 @@
 # Copyright: (c) 2017-2026 Anton van Wezenbeek
 ################################################################################
 
-TEMPLATE = app
-QT += widgets
-RC_FILE = fractal.rc
+# The core library offers the fractals, geometry and renderer without
+# widgets or qwt, the app is the fractal browser using it, and the cli
+# renders without display, test has the tests of the core library.
+TEMPLATE = subdirs
 
-win32 {
-  include ( c:\qwt\features\qwt.prf )
-}
+SUBDIRS = \
+  core \
+  app \
+  cli \
+  test
 
-linux-g++ {
-  include ( /usr/local/qwt/features/qwt.prf )
-}
-
-macx {
-  include ( /usr/local/Cellar/homebrew/Cellar/qwt/6.3.0/features/qwt.prf )
-}
-
-HEADERS += \
-  fractal.h \
-  fractalcontrol.h \
-  fractalgeometry.h \
-  fractalrenderer.h \
-  fractalwidget.h \
-  mainwindow.h \
-  plotitem.h \
-  plotzoomer.h \
-  scrollbar.h
-
-SOURCES += \
-  fractal.cpp \
-  fractalcontrol.cpp \
-  fractalgeometry.cpp \
-  fractalrenderer.cpp \
-  fractalwidget.cpp \
-  main.cpp \
-  mainwindow.cpp \
-  plotitem.cpp \
-  plotzoomer.cpp \
-  scrollbar.cpp
+app.depends = core
+cli.depends = core
+test.depends = core
@@ -0,0 +1,17 @@
+################################################################################
+# Name:      test.pro
+# Purpose:   Qt project file of the tests of the core library
+# Author:    Anton van Wezenbeek
+# Copyright: (c) 2026 Anton van Wezenbeek
+################################################################################
+
+TEMPLATE = app
+TARGET = fractal-test
+QT = core gui testlib
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+include ( ../core/core.pri )
+
+SOURCES += \
+  testrenderer.cpp
@@ -0,0 +1,244 @@
+////////////////////////////////////////////////////////////////////////////////
+// Name:      testrenderer.cpp
+// Purpose:   Tests of class FractalRenderer
+// Author:    Anton van Wezenbeek
+// Copyright: (c) 2026 Anton van Wezenbeek
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+#include "fractalrenderer.h"
+
+class TestRenderer : public QObject
+{
+  Q_OBJECT
+private slots:
+  void checkpointSuperseded();
+  void gridPoints();
+  void keepOrbits();
+  void perturbationGlitches();
+};
+
+// Renders an image, and waits until it is ready.
+static bool renderReady(
+  FractalRenderer& renderer, const Fractal& fractal, 
+  const QSize& size, const FractalGeometry& geo)
+{
+  QSignalSpy spy(&renderer, &FractalRenderer::rendered);
+
+  if (!renderer.render(fractal, size, geo))
+  {
+    return false;
+  }
+
+  return QTest::qWaitFor([&]() {
+    return std::any_of(spy.begin(), spy.end(),
+      [&](const QList<QVariant>& args) {
+        return 
+          args.at(0).toInt() == RENDERING_READY &&
+          args.at(1).toInt() == renderer.generation();});}, 20000);
+}
+
+void TestRenderer::checkpointSuperseded()
+{
+  QTemporaryDir dir;
+  const QString checkpoint(dir.filePath("checkpoint.frame"));
+  const Fractal fractal("mandelbrot set");
+
+  FractalRenderer renderer;
+  renderer.setCacheSize(0);
+  renderer.setCheckpoint(checkpoint, 1);
+  renderer.setThreads(1);
+
+  // Image A is deep enough to be checkpointed before it is finished.
+  FractalGeometry a(
+    FractalInterval(0.73, 0.77), FractalInterval(0, 0.04), 200000);
+  a.setColours(64);
+  a.setPasses(1);
+
+  QVERIFY(renderer.render(fractal, QSize(4000, 4000), a));
+  renderer.start();
+  QTRY_VERIFY_WITH_TIMEOUT(QFileInfo::exists(checkpoint), 20000);
+
+  // Image B supersedes A, and is finished before the next interval.
+  QSignalSpy spy(&renderer, &FractalRenderer::rendered);
+  FractalGeometry b(FractalInterval(-2, 2), FractalInterval(-2, 2), 64);
+  b.setColours(64);
+  b.setPasses(1);
+
+  QVERIFY(renderer.render(fractal, QSize(64, 64), b));
+  QTRY_VERIFY_WITH_TIMEOUT(std::any_of(spy.begin(), spy.end(),
+    [&](const QList<QVariant>& args) {
+      return 
+        args.at(0).toInt() == RENDERING_READY &&
+        args.at(1).toInt() == renderer.generation();}), 20000);
+
+  // The checkpoint of A is not continued after a restart.
+  QVERIFY(!QFileInfo::exists(checkpoint));
+}
+
+void TestRenderer::gridPoints()
+{
+  const Fractal fractal("mandelbrot set");
+  const QSize size(64, 48);
+  
+  // A view for each precision that has a kernel, rendered in passes,
+  // so the coarse passes calculate tiles of blocks. The double view
+  // is resolved by float for blocks of the coarse passes.
+  FractalGeometry views[3];
+  views[0].setView(FractalInterval(-1, 2), FractalInterval(-1.2, 1.2));
+  views[1].setView(
+    BigReal::fromString("0.74364388703715870475"),
+    BigReal::fromString("0.13182590420531197049"), 4e-3, 3e-3);
+  views[2].setView(
+    BigReal::fromString("0.74364388703715870475"),
+    BigReal::fromString("0.13182590420531197049"), 4e-14, 3e-14);
+  
+  const FractalPrecision precisions[3] = {
+    PRECISION_FLOAT, PRECISION_DOUBLE, PRECISION_DOUBLE_DOUBLE};
+  const int depths[3] = {300, 300, 5000};
+  
+  for (int v = 0; v < 3; v++)
+  {
+    FractalGeometry& geo(views[v]);
+    geo.setColours(64);
+    geo.setDepth(depths[v]);
+    geo.setPasses(3);
+    
+    // Tiles are calculated as a grid, unless orbits are kept,
+    // then each point is calculated by itself.
+    FractalRenderer grid;
+    grid.setCacheSize(0);
+    grid.start();
+    QVERIFY(renderReady(grid, fractal, size, geo));
+    QCOMPARE(grid.precision(), precisions[v]);
+    
+    FractalRenderer points;
+    points.setCacheSize(0);
+    points.setKeepOrbits(true);
+    points.start();
+    QVERIFY(renderReady(points, fractal, size, geo));
+    QCOMPARE(points.precision(), precisions[v]);
+    
+    for (int y = 0; y < size.height(); y++)
+    {
+      for (int x = 0; x < size.width(); x++)
+      {
+        QCOMPARE(grid.frame().count(QPoint(x, y)), 
+          points.frame().count(QPoint(x, y)));
+      }
+    }
+  }
+}
+
+void TestRenderer::keepOrbits()
+{
+  QTemporaryDir dir;
+  const QString file(dir.filePath("orbits.frame"));
+  const Fractal fractal("mandelbrot set");
+  const QSize size(200, 150);
+
+  FractalGeometry geo(
+    FractalInterval(-0.3, 0.1), FractalInterval(0.6, 0.9), 500);
+  geo.setColours(64);
+  geo.setPasses(1);
+
+  FractalRenderer renderer;
+  renderer.setCacheSize(0);
+  renderer.start();
+
+  // Orbits are opt in.
+  QVERIFY(renderReady(renderer, fractal, size, geo));
+  QVERIFY(!renderer.frame().isResumable());
+
+  renderer.setKeepOrbits(true);
+  geo.setDepth(400);
+  QVERIFY(renderReady(renderer, fractal, size, geo));
+  QVERIFY(renderer.frame().isResumable());
+  QVERIFY(renderer.saveFrame(file));
+
+  FractalFrame opened;
+  QVERIFY(opened.open(file));
+  QVERIFY(opened.isResumable());
+
+  // A higher depth continues the orbits, of the last image and of 
+  // an opened frame, giving the counts of an image that is not continued.
+  FractalGeometry deeper(geo);
+  deeper.setDepth(1600);
+
+  FractalRenderer fresh;
+  fresh.setCacheSize(0);
+  fresh.setKeepOrbits(true);
+  fresh.start();
+  QVERIFY(renderReady(fresh, fractal, size, deeper));
+
+  FractalRenderer continued;
+  continued.setCacheSize(0);
+  continued.setFrame(opened);
+  continued.start();
+  QVERIFY(renderReady(continued, fractal, size, deeper));
+  QCOMPARE(continued.frame().start(), 400);
+
+  QVERIFY(renderReady(renderer, fractal, size, deeper));
+  QCOMPARE(renderer.frame().start(), 400);
+
+  for (int y = 0; y < size.height(); y++)
+  {
+    for (int x = 0; x < size.width(); x++)
+    {
+      QCOMPARE(renderer.frame().count(QPoint(x, y)), 
+        fresh.frame().count(QPoint(x, y)));
+      QCOMPARE(continued.frame().count(QPoint(x, y)), 
+        fresh.frame().count(QPoint(x, y)));
+    }
+  }
+}
+
+void TestRenderer::perturbationGlitches()
+{
+  const Fractal fractal("mandelbrot set");
+  const int depth = 100000;
+  const int count = 1000;
+  
+  // Points approaching the cusp of the main cardioid from outside, 
+  // each one escaping later than the one before, with the reference 
+  // outside all of them. Each new reference only resolves the points 
+  // escaping before it, so there are more glitched points than 
+  // new references.
+  const double reference = -0.26;
+  std::vector<std::complex<double>> dc(count);
+  std::vector<int> n(count);
+  
+  for (int i = 0; i < count; i++)
+  {
+    dc[i] = 0.01 - 0.01 * std::pow(0.5, 20.0 * i / count);
+  }
+  
+  Perturbation perturbation(
+    fractal, BigReal(reference, 4), BigReal(0, 4), depth);
+  QVERIFY(perturbation.reference());
+  QVERIFY(perturbation.calc(dc.data(), n.data(), count));
+  
+  // The first reference and all new references are used.
+  QCOMPARE(perturbation.references(), 1 + 8);
+  
+  // Each point gets the count of a calculation in double-double.
+  for (int i = 0; i < count; i++)
+  {
+    DoubleDouble x(DoubleDouble(reference) + DoubleDouble(dc[i].real()));
+    DoubleDouble y(0);
+    int expected;
+    
+    QVERIFY(fractal.kernelDoubleDouble()(
+      fractal, &x, &y, &expected, 1, depth, nullptr));
+    QCOMPARE(n[i], expected);
+  }
+}
+
+QTEST_GUILESS_MAIN(TestRenderer)
+
+#include "testrenderer.moc"